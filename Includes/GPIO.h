@@ -64,6 +64,10 @@ extern void GPIO_Interrupt_Enable(GPIO aDesc);
 // aDesc   GPIO Descriptor
 // aValue  false
 //         true
+//
+// The function disables the interrupts while it modifies the port. It can
+// be called from an interrupt handler, even when the application modifies
+// other bits of the same port.
 extern void GPIO_Output(GPIO aDesc, uint8_t aValue);
 
 // Return  false
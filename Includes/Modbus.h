@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Includes/Modbus.h
@@ -16,10 +16,26 @@
 // Constants
 // //////////////////////////////////////////////////////////////////////////
 
+#define MODBUS_ADU_MAX_byte (256)
+
+#define MODBUS_DEVICE_BROADCAST (0)
+
 #define MODBUS_BYTE_DEVICE    (0)
 #define MODBUS_BYTE_FUNCTION  (1)
 #define MODBUS_BYTE_EXCEPTION (2)
 
+// Sub-functions of MODBUS_FUNCTION_DIAGNOSTICS
+#define MODBUS_DIAGNOSTICS_RETURN_QUERY_DATA            (0x0000)
+#define MODBUS_DIAGNOSTICS_CLEAR_COUNTERS               (0x000a)
+#define MODBUS_DIAGNOSTICS_BUS_MESSAGE_COUNT            (0x000b)
+#define MODBUS_DIAGNOSTICS_BUS_COMM_ERROR_COUNT         (0x000c)
+#define MODBUS_DIAGNOSTICS_BUS_EXCEPTION_COUNT          (0x000d)
+#define MODBUS_DIAGNOSTICS_SERVER_MESSAGE_COUNT         (0x000e)
+#define MODBUS_DIAGNOSTICS_SERVER_NO_RESPONSE_COUNT     (0x000f)
+#define MODBUS_DIAGNOSTICS_SERVER_BUSY_COUNT            (0x0011)
+#define MODBUS_DIAGNOSTICS_BUS_CHARACTER_OVERRUN_COUNT  (0x0012)
+#define MODBUS_DIAGNOSTICS_CLEAR_OVERRUN                (0x0014)
+
 #define MODBUS_EXCEPTION_ILLEGAL_FUNCTION                        (0x01)
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS                    (0x02)
 #define MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE                      (0x03)
@@ -30,11 +46,35 @@
 #define MODBUS_EXCEPTION_GATEWAY_PATH_UNAVAILABLE                (0x0a)
 #define MODBUS_EXCEPTION_GATEWAY_TARGET_DEVICE_FAILED_TO_RESPOND (0x0b)
 
+#define MODBUS_COIL_OFF (0x0000)
+#define MODBUS_COIL_ON  (0xff00)
+
+#define MODBUS_FUNCTION_READ_COILS               (0x01)
+#define MODBUS_FUNCTION_READ_DISCRETE_INPUTS     (0x02)
 #define MODBUS_FUNCTION_READ_HOLDING_REGISTERS   (0x03)
 #define MODBUS_FUNCTION_READ_INPUT_REGISTERS     (0x04)
+#define MODBUS_FUNCTION_WRITE_SINGLE_COIL        (0x05)
 #define MODBUS_FUNCTION_WRITE_SINGLE_REGISTER    (0x06)
+#define MODBUS_FUNCTION_DIAGNOSTICS              (0x08)
+#define MODBUS_FUNCTION_WRITE_MULTIPLE_COILS     (0x0f)
 #define MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS (0x10)
 
+#define MODBUS_FUNCTION_READ_FILE_RECORD              (0x14)
+#define MODBUS_FUNCTION_WRITE_FILE_RECORD             (0x15)
+#define MODBUS_FUNCTION_MASK_WRITE_REGISTER           (0x16)
+#define MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS (0x17)
+#define MODBUS_FUNCTION_READ_FIFO_QUEUE               (0x18)
+
 #define MODBUS_FUNCTION_ERROR (0x80)
 
 #define MODBUS_NO_ERROR (0)
+
+#define MODBUS_FIFO_COUNT_MAX (31)
+
+#define MODBUS_READ_BITS_MAX  (2000)
+#define MODBUS_WRITE_BITS_MAX (1968)
+
+#define MODBUS_READ_REGISTERS_MAX  (125)
+#define MODBUS_WRITE_REGISTERS_MAX (123)
+
+#define MODBUS_READ_WRITE_REGISTERS_MAX (121)
@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Includes/Modbus_CRC.h
@@ -21,14 +21,14 @@ Modbus_CRC;
 
 // aInOut        Buffer containing data and where the CRC is added.
 // aInSize_byte  Size of data already in the buffer (excluding CRC)
-extern void Modbus_CRC_Compute_Buffer(uint8_t* aInOut, uint8_t aInSize_byte);
+extern void Modbus_CRC_Compute_Buffer(uint8_t* aInOut, uint16_t aInSize_byte);
 
 // aIn           The received data
 // aInSize_byte  Size of data in the buffer (including CRC)
 //
 // Return  false  Invalid CRC
 //         true   Valid CRC
-extern uint8_t Modbus_CRC_Verify_Buffer(const uint8_t* aIn, uint8_t aInSize_byte);
+extern uint8_t Modbus_CRC_Verify_Buffer(const uint8_t* aIn, uint16_t aInSize_byte);
 
 extern void Modbus_CRC_Init(Modbus_CRC* aThis);
 
@@ -0,0 +1,192 @@
+
+// Product   KMS-uC
+// License   http://www.apache.org/licenses/LICENSE-2.0
+
+/// \author    KMS - Martin Dubois, P. Eng.
+/// \copyright Copyright &copy; 2026 KMS
+/// \file      Includes/Modbus_Master.h
+/// \brief     Functions to send Modbus requests
+
+#pragma once
+
+// ===== Includes ===========================================================
+#include "GPIO.h"
+#include "Modbus.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+/// \brief The request is waiting or in progress
+#define MODBUS_MASTER_PENDING (0xff)
+
+/// \brief The slave did not respond, or the response was invalid
+#define MODBUS_MASTER_TIMEOUT (0xfe)
+
+// Data type
+// //////////////////////////////////////////////////////////////////////////
+
+struct Modbus_Master_Request_s;
+
+/// \brief Completion callback
+/// \param aRequest The request, mResult indicates the result
+typedef void (*Modbus_Master_Callback)(struct Modbus_Master_Request_s* aRequest);
+
+// mContext      Way to pass data to the callback
+// mDevice       The slave address, 1 to 247
+// mFunction     MODBUS_FUNCTION_READ_HOLDING_REGISTERS,
+//               MODBUS_FUNCTION_READ_INPUT_REGISTERS,
+//               MODBUS_FUNCTION_WRITE_SINGLE_REGISTER or
+//               MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS
+// mAddress      The first register address
+// mCount        Register count. Must be 1 for
+//               MODBUS_FUNCTION_WRITE_SINGLE_REGISTER.
+// mData         Read: The response data go there
+//               Write: The data to write
+// mOnCompleted  Optional. Called when the request completes, including
+//               after an error.
+// mPeriod_ms    Poll list only. Delay between two executions of the
+//               request.
+// mPriority     Poll list only. When many requests are due, the one with
+//               the lowest value is sent first.
+// mResult       MODBUS_NO_ERROR, MODBUS_EXCEPTION_..., MODBUS_MASTER_PENDING
+//               or MODBUS_MASTER_TIMEOUT
+// mFrame        Optional. A complete request frame, including the CRC, to
+//               send as is. mDevice must match its first byte. mFunction,
+//               mAddress, mCount and mData are ignored. The response frame
+//               replaces the request. mResult is MODBUS_NO_ERROR when a
+//               valid frame, exception responses included, is received.
+// mFrameSize_byte  Request size in, response size out
+// mFrameMax_byte   Size of the mFrame buffer
+// Other members Reserved to Modbus_Master. Set them to 0.
+
+/// \brief Modbus request
+/// \see Modbus_Master_Init Modbus_Master_Submit
+typedef struct Modbus_Master_Request_s
+{
+    void* mContext;
+
+    uint8_t  mDevice  ;
+    uint8_t  mFunction;
+    uint16_t mAddress ;
+    uint16_t mCount   ;
+
+    uint16_t* mData;
+
+    Modbus_Master_Callback mOnCompleted;
+
+    uint16_t mPeriod_ms;
+    uint8_t  mPriority ;
+
+    uint8_t mResult;
+
+    uint8_t* mFrame;
+    uint16_t mFrameSize_byte;
+    uint16_t mFrameMax_byte;
+
+    struct Modbus_Master_Request_s* mNext;
+
+    uint16_t mBackOff_ms;
+    uint16_t mElapsed_ms;
+    uint8_t  mRetries   ;
+}
+Modbus_Master_Request;
+
+/// \brief Modbus master instance
+/// \see Modbus_Master_Init
+typedef struct
+{
+    uint8_t mUART ;
+    uint8_t mState;
+
+    GPIO mOutputEnable;
+
+    Modbus_Master_Request* mCurrent ;
+    Modbus_Master_Request  mForward ;
+    Modbus_Master_Request* mQueue   ;
+    Modbus_Master_Request* mRequests;
+    uint8_t                mRequestQty;
+
+    uint8_t  mRetryMax;
+    uint16_t mTimeout_ms;
+    uint16_t mT35_us;
+
+    uint16_t mExpected_byte;
+    uint16_t mSize_byte;
+
+    uint8_t mBuffer[MODBUS_ADU_MAX_byte];
+}
+Modbus_Master;
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+/// \brief Initialize an instance
+/// \param aThis         The instance
+/// \param aUART         The UART index
+/// \param aRequests     The poll list
+/// \param aRequestQty   The number of requests in the poll list
+/// \param aOutputEnable This GPIO to set to 1 when transmiting.
+///
+/// The requests of the poll list are sent periodically.
+///
+/// The UART uses 19200 bps, 8N1. Call UART_Configure after this function
+/// to change it. The frame timing follows the new rate.
+
+// .mBit
+// .mDrive
+// .mInterrupt_Falling
+// .mOutput            : Ignored, must be an output
+// .mPort              : See GPIO_PORT_...
+// .mPull_Enable
+// .mPullUp_Select
+// .mPushPull
+// .mSlewRate_Slow     : Ignored, must be set
+extern void Modbus_Master_Init(Modbus_Master* aThis, uint8_t aUART, Modbus_Master_Request* aRequests, uint8_t aRequestQty, GPIO aOutputEnable);
+
+/// \brief Configure the error processing
+/// \param aThis       The instance
+/// \param aTimeout_ms Response timeout. The default is 100 ms.
+/// \param aRetryMax   Number of retries after a timeout. The default is 2.
+///
+/// When a poll list request fails after all its retries, its next
+/// execution is delayed. The delay doubles at each failure, up to 1 s, and
+/// returns to 0 after a success.
+extern void Modbus_Master_InitRetry(Modbus_Master* aThis, uint16_t aTimeout_ms, uint8_t aRetryMax);
+
+/// \brief Forward a request frame received by a gateway
+/// \param aContext         The Modbus_Master instance
+/// \param aFrame           The request frame, including the CRC. The
+///                         function replaces it with the response frame.
+/// \param aSize_byte       Request size in, response size out
+/// \param aBufferSize_byte The size of the aFrame buffer
+/// \retval MODBUS_NO_ERROR
+/// \retval MODBUS_EXCEPTION_GATEWAY_TARGET_DEVICE_FAILED_TO_RESPOND
+/// \retval MODBUS_MASTER_PENDING Call the function again later
+/// \see Modbus_Slave_Forward
+///
+/// Each instance forwards one frame at a time. The frame is queued like a
+/// submitted request. MODBUS_MASTER_PENDING has the same value as
+/// MODBUS_SLAVE_PENDING.
+extern uint8_t Modbus_Master_Forward(void* aContext, uint8_t* aFrame, uint16_t* aSize_byte, uint16_t aBufferSize_byte);
+
+/// \brief Send a request once
+/// \param aThis    The instance
+/// \param aRequest The request. It must stay valid until mResult is not
+///                 MODBUS_MASTER_PENDING anymore.
+///
+/// The submitted requests are sent in order, before the poll list
+/// requests.
+extern void Modbus_Master_Submit(Modbus_Master* aThis, Modbus_Master_Request* aRequest);
+
+/// \brief Periodic work
+/// \param aThis      The instance
+/// \param aPeriod_ms Delay since the last call
+extern void Modbus_Master_Tick(Modbus_Master* aThis, uint16_t aPeriod_ms);
+
+/// \brief Idle work
+/// \param aThis The instance
+///
+/// Call it as often as possible. The next request is prepared as soon as
+/// the response is received and sent when the line was silent for 3.5
+/// characters.
+extern void Modbus_Master_Work(Modbus_Master* aThis);
@@ -12,9 +12,78 @@
 // ===== Includes ===========================================================
 #include "GPIO.h"
 
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+/// \brief Callback return value indicating the operation is not completed
+/// \see Modbus_Slave_Callback Modbus_Slave_InitPending
+#define MODBUS_SLAVE_PENDING (0xff)
+
 // Data type
 // //////////////////////////////////////////////////////////////////////////
 
+// mFrame           The buffer receiving the response, including the CRC
+// mFrameSize_byte  The size of mFrame. A response not fitting in the buffer
+//                  is not cached.
+// Other members    Reserved to Modbus_Slave. Set them to 0.
+
+/// \brief Response cache of a read range
+/// \see Modbus_Slave_Publish
+typedef struct
+{
+    uint8_t* mFrame;
+    uint16_t mFrameSize_byte;
+
+    uint16_t mAddress;
+    uint16_t mCount;
+    uint8_t  mDevice;
+    uint8_t  mFilling;
+    uint8_t  mFunction;
+    uint16_t mSize_byte;
+}
+Modbus_Slave_Cache;
+
+// mBits          One bit per register, or per bit, of the range. Bit 0 of
+//                mBits[0] is the first register. The size is
+//                (mCount + 15) / 16 words. Initialize it to 0.
+// Other members  Reserved to Modbus_Slave. Set them to 0.
+
+/// \brief Registers written through Modbus
+/// \see Modbus_Slave_NextDirty
+typedef struct
+{
+    uint16_t* mBits;
+
+    uint16_t mFirst;
+    uint16_t mEnd;
+}
+Modbus_Slave_Dirty;
+
+// mReads       Read operations, the cached responses included
+// mWrites      Write operations
+// mRegisters   Registers, or bits, the read and write operations
+//              transferred
+// mExceptions  Operations a callback rejected with an exception. They
+//              are not counted in mReads or mWrites.
+// mAccess_ms   Time of the last operation, exception included. The time
+//              is the sum of the Modbus_Slave_Tick periods.
+// Initialize the structure to 0. The counters wrap around. The application
+// may clear them at any time from the context calling Modbus_Slave_Work.
+// After Modbus_Slave_InitFastRead, the receive interrupt handler also
+// updates them.
+
+/// \brief Access statistics of a range
+/// \see Modbus_Slave_GetStats
+typedef struct
+{
+    uint16_t mReads;
+    uint16_t mWrites;
+    uint32_t mRegisters;
+    uint16_t mExceptions;
+    uint32_t mAccess_ms;
+}
+Modbus_Slave_Stats;
+
 struct Modbus_Slave_Range_s;
 
 /// \brief Modbus callback
@@ -24,12 +93,28 @@ struct Modbus_Slave_Range_s;
 /// \param aData    Data
 /// \retval MODBUS_NO_ERROR
 /// \retval MODBUS_EXCEPTION_...
+/// \retval MODBUS_SLAVE_PENDING
+///
+/// A callback returning MODBUS_SLAVE_PENDING is called again, with the same
+/// arguments, at each Modbus_Slave_Work until it returns another value,
+/// even after the Modbus_Slave_InitPending timeout. The callbacks already
+/// completed for the same request are not called again. aData keeps what
+/// the callback wrote there between the calls. Use it to start a slow
+/// operation, an EEPROM access for example, and report its completion
+/// later.
+///
+/// The callbacks are called from Modbus_Slave_Work. After
+/// Modbus_Slave_InitFastRead, Modbus_Slave_Callback_Default can also be
+/// called as mAfterRead from the receive interrupt handler.
 typedef uint8_t (*Modbus_Slave_Callback)(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
 
 // mContext      Way to pass data to the callbacks
 // mAddress      The starting address in the Modbus address space
-// mCount        Number of 16 bits registers. Must be at least 1.
-// mData         Optional. The address of the data storage. If NULL
+// mCount        Number of 16 bits registers, or number of bits for coil and
+//               discrete input ranges. Must be at least 1.
+// mData         Optional. The address of the data storage. For coil and
+//               discrete input ranges, the bits are packed, bit 0 of
+//               mData[0] is the first bit of the range. If NULL
 //               - mAfterRead must set aData
 //               - mAfterWrite or mBeforeWrite must save aData to internal
 //                 storage if needed
@@ -40,6 +125,24 @@ typedef uint8_t (*Modbus_Slave_Callback)(struct Modbus_Slave_Range_s* aRange, ui
 // mBeforeWrite  Mandatory. If not needed, set it to
 //               Modbus_Slave_Callback_Default. If the range is read only,
 //               set it to Modbus_Slave_Callback_Error
+// mCache        Optional. When set, the last read response is kept and sent
+//               again as is for the same unit ID, function, address and
+//               count. mAfterRead is not called for these repeated reads. A
+//               write through Modbus or a call to Modbus_Slave_Publish
+//               discards the cached response.
+// mBack         Optional. Second data storage, same size as mData. The
+//               application fills it, then calls Modbus_Slave_Commit to
+//               swap mData and mBack. Modbus reads always see a complete
+//               snapshot. After the swap, mBack contains an older snapshot
+//               and the application must rewrite all of it. Values written
+//               through Modbus go to mData only, use mAfterWrite to report
+//               them to the application.
+// mCommits      Reserved to Modbus_Slave. Set it to 0.
+// mDirty        Optional. When set, Modbus_Slave marks the registers
+//               written through Modbus. Use Modbus_Slave_NextDirty to
+//               retrieve them.
+// mStats        Optional. When set, Modbus_Slave counts the operations on
+//               the range. Use Modbus_Slave_GetStats to retrieve them.
 
 /// \brief Modbus address rance
 /// \see Modbus_Slave_Callback Modbus_Slave_Init
@@ -55,9 +158,217 @@ typedef struct Modbus_Slave_Range_s
     Modbus_Slave_Callback mAfterRead  ;
     Modbus_Slave_Callback mAfterWrite ;
     Modbus_Slave_Callback mBeforeWrite;
+
+    Modbus_Slave_Cache* mCache;
+
+    uint16_t* mBack;
+
+    volatile uint8_t mCommits;
+
+    Modbus_Slave_Dirty* mDirty;
+
+    Modbus_Slave_Stats* mStats;
 }
 Modbus_Slave_Range;
 
+// mNumber    The file number, 1 to 65535
+// mRanges    The record ranges. Modbus_Slave_Range::mAddress is the first
+//            record number, 0 to 9999, and each record is a 16 bits
+//            register. Modbus_Slave_Range::mCache is not used.
+// mRangeQty  The number of record ranges
+
+/// \brief File accessed with FC20 and FC21
+/// \see Modbus_Slave_InitFiles
+typedef struct
+{
+    uint16_t mNumber;
+
+    Modbus_Slave_Range* mRanges;
+    uint8_t             mRangeQty;
+}
+Modbus_Slave_File;
+
+// mAddress       The FIFO pointer address of the FC24 requests
+// mData          The storage
+// mSize          The number of entries of mData. The FIFO holds up to
+//                mSize - 1 values.
+// mOverflows     Values Modbus_Slave_FIFO_Push dropped because the FIFO
+//                was full
+// Other members  Reserved to Modbus_Slave. Set them to 0.
+
+/// \brief Queue read with FC24
+/// \see Modbus_Slave_FIFO_Push Modbus_Slave_InitFIFOs
+typedef struct
+{
+    uint16_t mAddress;
+
+    uint16_t* mData;
+    uint16_t  mSize;
+
+    volatile uint16_t mOverflows;
+
+    volatile uint16_t mIn ; // Written by Modbus_Slave_FIFO_Push only
+    volatile uint16_t mOut; // Written by Modbus_Slave only
+}
+Modbus_Slave_FIFO;
+
+// mDevice    The unit ID, 1 to 247
+// mRanges    The register ranges
+// mRangeQty  The number of register ranges
+// mCoils     The coil ranges (FC01, FC05 and FC15)
+// mCoilQty   The number of coil ranges
+// mInputs    The discrete input ranges (FC02)
+// mInputQty  The number of discrete input ranges
+// mFiles     The files (FC20 and FC21)
+// mFileQty   The number of files
+// mFIFOs     The FIFOs (FC24)
+// mFIFOQty   The number of FIFOs
+
+/// \brief Virtual slave device
+/// \see Modbus_Slave_InitUnits
+typedef struct
+{
+    uint8_t mDevice;
+
+    Modbus_Slave_Range* mRanges;
+    uint8_t             mRangeQty;
+
+    Modbus_Slave_Range* mCoils;
+    uint8_t             mCoilQty;
+
+    Modbus_Slave_Range* mInputs;
+    uint8_t             mInputQty;
+
+    const Modbus_Slave_File* mFiles;
+    uint8_t                  mFileQty;
+
+    Modbus_Slave_FIFO* mFIFOs;
+    uint8_t            mFIFOQty;
+}
+Modbus_Slave_Unit;
+
+/// \brief Forward a request to another bus
+/// \param aContext         Modbus_Slave_Route::mContext
+/// \param aFrame           The request frame, including the CRC. The
+///                         function replaces it with the response frame.
+/// \param aSize_byte       Request size in, response size out, including
+///                         the CRC
+/// \param aBufferSize_byte The size of the aFrame buffer
+/// \retval MODBUS_NO_ERROR
+/// \retval MODBUS_EXCEPTION_GATEWAY_...
+/// \retval MODBUS_SLAVE_PENDING
+///
+/// The function is called again, with the same arguments, until it returns
+/// another value than MODBUS_SLAVE_PENDING. Modbus_Master_Forward is a
+/// forward function.
+typedef uint8_t (*Modbus_Slave_Forward)(void* aContext, uint8_t* aFrame, uint16_t* aSize_byte, uint16_t aBufferSize_byte);
+
+// mContext  Way to pass data to the forward function. For
+//           Modbus_Master_Forward, the Modbus_Master instance.
+// mForward  Optional. If NULL, the requests for these unit IDs receive
+//           MODBUS_EXCEPTION_GATEWAY_PATH_UNAVAILABLE.
+// mFirst    The first unit ID
+// mLast     The last unit ID
+
+/// \brief Unit IDs reached through a gateway
+/// \see Modbus_Slave_InitGateway
+typedef struct
+{
+    void* mContext;
+
+    Modbus_Slave_Forward mForward;
+
+    uint8_t mFirst;
+    uint8_t mLast ;
+}
+Modbus_Slave_Route;
+
+// mBusMessages       Frames received, valid or not
+// mBusCommErrors     Frames received with a CRC or a framing error. The RTU
+//                    transport does not verify the frames for other
+//                    slaves.
+// mBusExceptions     Exception responses, including the ones to broadcast
+//                    requests, which are not sent
+// mServerMessages    Requests for this slave, broadcast requests included
+// mServerNoResponses Requests for this slave not answered, the broadcast
+//                    requests
+// mServerBusy        MODBUS_EXCEPTION_SERVER_DEVICE_BUSY responses
+// mOverruns          Receive overruns reported by the UART, the bytes
+//                    dropped because the receive ring buffer was full
+//                    included
+// mLatency           Response count per delay between the end of the
+//                    request and the start of the response. Entry i
+//                    counts the delays shorter than 500 us << i, not
+//                    counted by the previous entries. The last entry also
+//                    counts the longer delays.
+// The counters wrap around.
+
+/// \brief Number of entries of Modbus_Slave_Counters::mLatency
+#define MODBUS_SLAVE_LATENCY_QTY (8)
+
+/// \brief Diagnostic counters
+/// \see Modbus_Slave_GetCounters
+typedef struct
+{
+    uint16_t mBusMessages;
+    uint16_t mBusCommErrors;
+    uint16_t mBusExceptions;
+    uint16_t mServerMessages;
+    uint16_t mServerNoResponses;
+    uint16_t mServerBusy;
+    uint16_t mOverruns;
+
+    uint16_t mLatency[MODBUS_SLAVE_LATENCY_QTY];
+}
+Modbus_Slave_Counters;
+
+// mGPIOs   One GPIO descriptor per bit of the range
+// mInput   GPIO_Input, GPIO_Output_Get, Expander_GPIO_Input or
+//          Expander_GPIO_Output_Get. Needed by
+//          Modbus_Slave_Callback_GPIO_Input.
+// mOutput  GPIO_Output or Expander_GPIO_Output. Needed by
+//          Modbus_Slave_Callback_GPIO_Output.
+
+/// \brief Binding between a coil or discrete input range and GPIOs
+/// \see Modbus_Slave_Callback_GPIO_Input Modbus_Slave_Callback_GPIO_Output
+typedef struct
+{
+    const GPIO* mGPIOs;
+
+    uint8_t (*mInput )(GPIO aDesc);
+    void    (*mOutput)(GPIO aDesc, uint8_t aValue);
+}
+Modbus_Slave_GPIO;
+
+// mContext  Way to pass data to the functions
+// mReceive  Return 0 while no complete request is available. Otherwise,
+//           return the size of the request copied to aFrame, unit ID and
+//           PDU, without any header or trailer. The request must leave 2
+//           bytes free at the end of aFrame.
+// mSeal     Optional. Add the trailer, at most 2 bytes, after the response
+//           in aFrame and return the new size. The RTU transport adds the
+//           CRC.
+// mSend     Start sending the sealed response. aFrame stays valid until
+//           mSent returns another value than MODBUS_SLAVE_PENDING.
+// mSent     Return MODBUS_SLAVE_PENDING while sending, MODBUS_NO_ERROR when
+//           the transport is ready to receive the next request and any
+//           other value after an error.
+// mTick     Optional. Called by Modbus_Slave_Tick.
+
+/// \brief Transport of the requests and responses
+/// \see Modbus_Slave_InitTransport
+typedef struct
+{
+    void* mContext;
+
+    uint16_t (*mReceive)(void* aContext, uint8_t* aFrame, uint16_t aFrameSize_byte);
+    uint16_t (*mSeal   )(void* aContext, uint8_t* aFrame, uint16_t aSize_byte);
+    void     (*mSend   )(void* aContext, const uint8_t* aFrame, uint16_t aSize_byte);
+    uint8_t  (*mSent   )(void* aContext);
+    void     (*mTick   )(void* aContext, uint16_t aPeriod_ms);
+}
+Modbus_Slave_Transport;
+
 // Functions
 // //////////////////////////////////////////////////////////////////////////
 
@@ -67,6 +378,13 @@ Modbus_Slave_Range;
 /// \param aRanges       The register ranges
 /// \param aRangeQty     The number of ranges
 /// \param aOutputEnable This GPIO to set to 1 when transmiting.
+///
+/// Broadcast requests (unit ID 0) writing coils or registers are executed
+/// on the ranges passed here and to Modbus_Slave_InitBits. No response is
+/// sent. Other broadcast requests are ignored.
+///
+/// The UART uses 19200 bps, 8N1. Call UART_Configure after this function
+/// to change it. The frame timing follows the new rate.
 
 // .mBit
 // .mDrive
@@ -79,6 +397,105 @@ Modbus_Slave_Range;
 // .mSlewRate_Slow     : Ignored, must be set
 extern void Modbus_Slave_Init(uint8_t aUART, uint8_t aDevice, Modbus_Slave_Range* aRanges, uint8_t aRangeQty, GPIO aOutputEnable);
 
+/// \brief Initialize the module with another transport than Modbus RTU
+/// \param aTransport The transport. The function copies it.
+/// \param aDevice    The Modbus device address
+/// \param aRanges    The register ranges
+/// \param aRangeQty  The number of ranges
+///
+/// Call this function instead of Modbus_Slave_Init, for example to process
+/// the Modbus TCP frames of a serial to Ethernet bridge. The other
+/// Modbus_Slave_Init... functions work the same way after it. The
+/// transport updates no counter and Modbus_Slave_Counters::mOverruns and
+/// Modbus_Slave_Counters::mLatency stay 0. The gateway routes still
+/// receive RTU frames.
+extern void Modbus_Slave_InitTransport(const Modbus_Slave_Transport* aTransport, uint8_t aDevice, Modbus_Slave_Range* aRanges, uint8_t aRangeQty);
+
+/// \brief Add coil and discrete input ranges
+/// \param aCoils     The coil ranges (FC01, FC05 and FC15)
+/// \param aCoilQty   The number of coil ranges
+/// \param aInputs    The discrete input ranges (FC02)
+/// \param aInputQty  The number of discrete input ranges
+///
+/// Call this function after Modbus_Slave_Init. The callbacks of these
+/// ranges receive packed bits and aCount is a number of bits.
+extern void Modbus_Slave_InitBits(Modbus_Slave_Range* aCoils, uint8_t aCoilQty, Modbus_Slave_Range* aInputs, uint8_t aInputQty);
+
+/// \brief Respond to simple reads from the receive interrupt handler
+///
+/// Call this function after Modbus_Slave_Init. A Read Holding Registers
+/// (FC03) or Read Input Registers (FC04) request is processed as soon as
+/// its 8 bytes are received, without waiting for the 3.5 character silence
+/// nor for Modbus_Slave_Work, when its CRC is valid and the registers are
+/// part of a single range using Modbus_Slave_Callback_Default as
+/// mAfterRead. The other requests are processed by Modbus_Slave_Work as
+/// before. The range data, its mCache and mStats, and the counters are
+/// then accessed, and Modbus_Slave_Callback_Default is called, from the
+/// receive interrupt handler. The output enable GPIO is also set there,
+/// see GPIO_Output. Use mBack and Modbus_Slave_Commit to publish
+/// values using more than one register. Not available with
+/// Modbus_Slave_InitTransport.
+extern void Modbus_Slave_InitFastRead();
+
+/// \brief Add files
+/// \param aFiles   The files
+/// \param aFileQty The number of files
+///
+/// Call this function after Modbus_Slave_Init. Read File Record (FC20) and
+/// Write File Record (FC21) requests access the records through the
+/// callbacks of the record ranges, the same way as registers. A request
+/// may contain many sub-requests. The records of all the sub-requests of a
+/// FC20 request are read before the response is sent, a callback returning
+/// MODBUS_SLAVE_PENDING delays the whole response.
+extern void Modbus_Slave_InitFiles(const Modbus_Slave_File* aFiles, uint8_t aFileQty);
+
+/// \brief Add FIFOs
+/// \param aFIFOs   The FIFOs
+/// \param aFIFOQty The number of FIFOs
+///
+/// Call this function after Modbus_Slave_Init. Each Read FIFO Queue (FC24)
+/// request removes up to 31 values from the FIFO and returns them, oldest
+/// first. The FIFO count of the response is the number of values returned.
+extern void Modbus_Slave_InitFIFOs(Modbus_Slave_FIFO* aFIFOs, uint8_t aFIFOQty);
+
+/// \brief Forward the requests for other unit IDs
+/// \param aRoutes   The routes, sorted or not
+/// \param aRouteQty The number of routes
+///
+/// Call this function after Modbus_Slave_Init. The requests for unit IDs
+/// not part of any route are ignored. While a request is forwarded, the
+/// slave does not receive other requests and the Modbus_Slave_InitPending
+/// timeout does not apply. The timeout of the upstream master must be
+/// longer than the time the downstream bus needs to respond or fail.
+extern void Modbus_Slave_InitGateway(const Modbus_Slave_Route* aRoutes, uint8_t aRouteQty);
+
+/// \brief Respond to other unit IDs
+/// \param aUnits   The units, each with its own address space
+/// \param aUnitQty The number of units
+///
+/// Call this function after Modbus_Slave_Init and Modbus_Slave_InitBits.
+/// The unit configured by these functions stays active. The unit ID of a
+/// request is looked up in a table indexed by unit ID, so the number of
+/// units does not affect the processing time.
+extern void Modbus_Slave_InitUnits(const Modbus_Slave_Unit* aUnits, uint8_t aUnitQty);
+
+/// \brief Configure the processing of pending requests
+/// \param aTimeout_ms  Maximum time to wait for a callback returning
+///                     MODBUS_SLAVE_PENDING. The default is 100 ms.
+/// \param aException   MODBUS_EXCEPTION_SERVER_DEVICE_BUSY (default) or
+///                     MODBUS_EXCEPTION_ACKNOWLEDGE
+/// \see MODBUS_SLAVE_PENDING
+///
+/// When the timeout expires, the slave responds with aException, then
+/// completes the request in background and discards its response. The
+/// callbacks are never abandoned while pending. Requests received before
+/// the completion are ignored.
+/// - MODBUS_EXCEPTION_SERVER_DEVICE_BUSY  The master must send the request
+///   again.
+/// - MODBUS_EXCEPTION_ACKNOWLEDGE  The master knows the request is being
+///   executed.
+extern void Modbus_Slave_InitPending(uint16_t aTimeout_ms, uint8_t aException);
+
 /// \brief Default callback
 /// \param aRange   The address range
 /// \param aAddress Start address
@@ -97,6 +514,88 @@ extern uint8_t Modbus_Slave_Callback_Default(struct Modbus_Slave_Range_s* aRange
 /// \see Modbus_Slave_Callback
 extern uint8_t Modbus_Slave_Callback_Error(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
 
+/// \brief Read the bits from GPIOs
+/// \param aRange   The address range, mContext must point to a
+///                 Modbus_Slave_GPIO
+/// \param aAddress Start address
+/// \param aCount   Bit count
+/// \param aData    Packed bits
+/// \retval MODBUS_NO_ERROR
+/// \see Modbus_Slave_Callback Modbus_Slave_GPIO
+///
+/// Use it as mAfterRead of a coil or discrete input range.
+extern uint8_t Modbus_Slave_Callback_GPIO_Input(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+/// \brief Write the bits to GPIOs
+/// \param aRange   The address range, mContext must point to a
+///                 Modbus_Slave_GPIO
+/// \param aAddress Start address
+/// \param aCount   Bit count
+/// \param aData    Packed bits
+/// \retval MODBUS_NO_ERROR
+/// \see Modbus_Slave_Callback Modbus_Slave_GPIO
+///
+/// Use it as mAfterWrite of a coil range.
+extern uint8_t Modbus_Slave_Callback_GPIO_Output(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+/// \brief Publish the back buffer of a range
+/// \param aRange The address range, mBack must be set
+/// \see Modbus_Slave_Publish
+///
+/// Swap mData and mBack and discard the cached response. This function can
+/// be called from an interrupt handler. A read interrupted by the swap is
+/// restarted using the new data.
+extern void Modbus_Slave_Commit(Modbus_Slave_Range* aRange);
+
+/// \brief Add a value to a FIFO
+/// \param aFIFO  The FIFO
+/// \param aValue The value
+/// \retval false The FIFO is full, the value is dropped
+/// \retval true
+///
+/// The FIFO has a single producer. Call this function from one context
+/// only, the application or an interrupt handler. It does not disable the
+/// interrupts.
+extern uint8_t Modbus_Slave_FIFO_Push(Modbus_Slave_FIFO* aFIFO, uint16_t aValue);
+
+/// \brief Retrieve the diagnostic counters
+/// \param aOut The counters
+///
+/// The master reads the same counters using MODBUS_FUNCTION_DIAGNOSTICS
+/// and clears them using MODBUS_DIAGNOSTICS_CLEAR_COUNTERS, which also
+/// clears mLatency.
+extern void Modbus_Slave_GetCounters(Modbus_Slave_Counters* aOut);
+
+/// \brief Retrieve the access statistics of a range
+/// \param aRange The address range, mStats must be set
+/// \param aOut   The statistics
+/// \see Modbus_Slave_Stats
+///
+/// In aOut, mAccess_ms is the time elapsed since the last operation, or
+/// since the start if the range was never accessed. Use it to find the
+/// ranges the masters poll the most and the ones they never use. Call it
+/// from the same context as Modbus_Slave_Work.
+extern void Modbus_Slave_GetStats(const Modbus_Slave_Range* aRange, Modbus_Slave_Stats* aOut);
+
+/// \brief Retrieve the next register written through Modbus
+/// \param aRange   The address range, mDirty must be set
+/// \param aAddress The function puts the register address there
+/// \retval false No more written register
+/// \retval true
+/// \see Modbus_Slave_Dirty
+///
+/// The function clears the mark of the returned register. Only the part of
+/// the range written since the last complete iteration is scanned. Call it
+/// from the same context as Modbus_Slave_Work.
+extern uint8_t Modbus_Slave_NextDirty(Modbus_Slave_Range* aRange, uint16_t* aAddress);
+
+/// \brief Indicate the data of a range changed
+/// \param aRange The address range
+///
+/// Call this function after modifying the data of a range using a response
+/// cache. This function can be called from an interrupt handler.
+extern void Modbus_Slave_Publish(Modbus_Slave_Range* aRange);
+
 /// \brief Periodic work
 /// \param aPeriod_ms Delay since the last call
 extern void Modbus_Slave_Tick(uint16_t aPeriod_ms);
@@ -0,0 +1,67 @@
+
+// Product   KMS-uC
+// License   http://www.apache.org/licenses/LICENSE-2.0
+
+/// \author    KMS - Martin Dubois, P. Eng.
+/// \copyright Copyright &copy; 2026 KMS
+/// \file      Includes/Modbus_Slave_EEPROM.h
+/// \brief     Modbus_Slave callbacks accessing an EEPROM
+
+#pragma once
+
+// ===== Includes ===========================================================
+#include "EEPROM.h"
+#include "Modbus_Slave.h"
+
+// Data type
+// //////////////////////////////////////////////////////////////////////////
+
+// mEEPROM        The EEPROM instance. The application keeps calling
+//                EEPROM_Tick and EEPROM_Work.
+// mAddress       EEPROM address of the first register of the range. Each
+//                register uses 2 bytes, the most significant first.
+// Other members  Reserved to the callbacks. Set them to 0.
+
+/// \brief Binding between a register or record range and an EEPROM
+/// \see Modbus_Slave_Callback_EEPROM_Read Modbus_Slave_Callback_EEPROM_Write
+typedef struct
+{
+    EEPROM* mEEPROM;
+    uint8_t mAddress;
+
+    uint8_t mStarted;
+}
+Modbus_Slave_EEPROM;
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+/// \brief Callback reading the registers from the EEPROM
+/// \param aRange   The address range. mContext points to a
+///                 Modbus_Slave_EEPROM and mData is NULL.
+/// \param aAddress Start address
+/// \param aCount   Register count
+/// \param aData    Data
+/// \retval MODBUS_NO_ERROR
+/// \retval MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE
+/// \retval MODBUS_SLAVE_PENDING
+///
+/// Use it as mAfterRead. The callback waits for the EEPROM to be idle,
+/// starts the read and returns MODBUS_SLAVE_PENDING until it completes.
+/// The EEPROM writes in aData until then. When the access lasts longer
+/// than the Modbus_Slave_InitPending timeout, the master receives the
+/// timeout exception and the access completes in background.
+extern uint8_t Modbus_Slave_Callback_EEPROM_Read(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+/// \brief Callback writing the registers to the EEPROM
+/// \param aRange   The address range. mContext points to a
+///                 Modbus_Slave_EEPROM and mData is NULL.
+/// \param aAddress Start address
+/// \param aCount   Register count
+/// \param aData    Data
+/// \retval MODBUS_NO_ERROR
+/// \retval MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE
+/// \retval MODBUS_SLAVE_PENDING
+///
+/// Use it as mAfterWrite. See Modbus_Slave_Callback_EEPROM_Read.
+extern uint8_t Modbus_Slave_Callback_EEPROM_Write(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Includes/Tick.h
@@ -15,3 +15,8 @@ extern void Tick_Init(uint32_t aClock_Hz);
 // Return  0      No tick
 //         Other  Tick period in ms
 extern uint16_t Tick_Work();
+
+// Free running time base, usable from interrupt context
+//
+// Return  Time in us. The value wraps around every 65.536 ms.
+extern uint16_t Tick_Now_us();
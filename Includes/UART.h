@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Includes/UART.h
@@ -17,12 +17,45 @@
 #define UART_PENDING (1)
 #define UART_SUCCESS (2)
 
+#define UART_PARITY_NONE (0)
+#define UART_PARITY_EVEN (1)
+#define UART_PARITY_ODD  (2)
+
+// Flags of the UART_Stream_Read values, the received byte is in the low
+// 8 bits
+#define UART_STREAM_GAP   (0x0100) // A silence of at least aGap_us came before the byte
+#define UART_STREAM_ERROR (0x0200) // Bytes were lost or received with an error before the byte
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+typedef void (*UART_Callback)(void* aContext);
+
 // Functions
 // //////////////////////////////////////////////////////////////////////////
 
 extern void UART_Init(uint8_t aIndex);
 
-// aOp  UART_READ
+// Return  Duration of one character on the line, in us
+extern uint16_t UART_CharTime_us(uint8_t aIndex);
+
+// aRate_bps  The baud rate, up to the bus clock / 16. The closest rate the
+//            peripheral generates is used, see UART_Rate_bps.
+// aParity    UART_PARITY_EVEN, UART_PARITY_NONE or UART_PARITY_ODD
+// aStopBits  1 or 2. 2 stop bits are only available without parity.
+//
+// UART_Init configures 19200 bps, 8 data bits, no parity and 1 stop bit.
+// Call this function after it, while no operation is pending. The
+// character time and the write timeouts follow the new configuration. A
+// write timeout lasts at least 20 ms, so UART_Tick can be called every
+// 10 ms at any rate.
+extern void UART_Configure(uint8_t aIndex, uint32_t aRate_bps, uint8_t aParity, uint8_t aStopBits);
+
+// Return  The longest silence between two bytes received by the current
+//         read operation, in us
+extern uint16_t UART_Gap_us(uint8_t aIndex);
+
+// aOp  UART_READ   Also leaves the stream mode
 //      UART_WRITE
 extern void UART_Abort(uint8_t aIndex, uint8_t aOp);
 
@@ -33,17 +66,68 @@ extern void UART_Abort(uint8_t aIndex, uint8_t aOp);
 //         1  Idle
 extern uint8_t UART_Idle(uint8_t aIndex, uint8_t aOp);
 
+// Return  The baud rate
+extern uint32_t UART_Rate_bps(uint8_t aIndex);
+
+// Return  Number of receive overruns since UART_Init, the bytes dropped
+//         because the stream buffer was full included. The value wraps
+//         around.
+extern uint16_t UART_Overruns(uint8_t aIndex);
+
+// aCallback  Called from the receive interrupt handler after it processed
+//            the received bytes. The callback can call UART_Abort,
+//            UART_Gap_us, UART_Silence_us, UART_Status, UART_Stream_Read
+//            and UART_Write. NULL removes the callback.
+extern void UART_SetRxData(uint8_t aIndex, UART_Callback aCallback, void* aContext);
+
 // aOp  UART_READ
 //      UART_WRITE
 extern void UART_SetTimeout(uint8_t aIndex, uint8_t aOp, uint16_t aTimeout_ms);
 
-extern void UART_Read(uint8_t aIndex, void* aOut, uint8_t aOutSize_byte);
+// aCallback  Called from the interrupt handler when the last byte of a
+//            write operation left the transmitter, before UART_Status
+//            reports UART_SUCCESS. The callback can call UART_Read and
+//            UART_SetTimeout. NULL removes the callback.
+extern void UART_SetTxComplete(uint8_t aIndex, UART_Callback aCallback, void* aContext);
+
+// The bytes received while no read operation is pending are dropped, they
+// do not make the next read fail.
+extern void UART_Read(uint8_t aIndex, void* aOut, uint16_t aOutSize_byte);
+
+// Return  Time elapsed since the last received byte, in us. The bytes
+//         received while no read operation is pending are also taken into
+//         account. The value saturates at 32.767 ms if UART_Tick is
+//         called periodically for UART_READ.
+extern uint16_t UART_Silence_us(uint8_t aIndex);
 
 // Return  UART_ERROR
 //         UART_PENDING
 //         UART_SUCCESS
-extern uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint8_t* aCount);
+extern uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint16_t* aCount);
+
+// aOut      The function puts the received bytes and their UART_STREAM_...
+//           flags there, oldest first.
+// aOutSize  The number of entries of aOut
+//
+// Only one context at a time can call it, the UART_SetRxData callback
+// included. It does not disable the interrupts.
+//
+// Return  The number of entries copied to aOut
+extern uint16_t UART_Stream_Read(uint8_t aIndex, uint16_t* aOut, uint16_t aOutSize);
+
+// aBuffer  The ring buffer
+// aSize    The number of entries of aBuffer. The buffer holds up to
+//          aSize - 1 bytes.
+// aGap_us  A byte received after a silence of at least aGap_us, or the
+//          first byte, gets the UART_STREAM_GAP flag.
+//
+// Start the stream mode. The receive interrupt handler stores all the
+// received bytes in aBuffer, without re-arming between messages, until
+// UART_Abort is called for UART_READ. The bytes are time stamped as
+// usual, so UART_Silence_us stays valid. Do not use UART_Read, UART_Gap_us
+// or UART_Status for UART_READ in stream mode.
+extern void UART_Stream_Start(uint8_t aIndex, uint16_t* aBuffer, uint16_t aSize, uint16_t aGap_us);
 
 extern void UART_Tick(uint8_t aIndex, uint8_t aOp, uint16_t aPeriod_ms);
 
-extern void UART_Write(uint8_t aIndex, const void* aIn, uint8_t aInSize_byte);
+extern void UART_Write(uint8_t aIndex, const void* aIn, uint16_t aInSize_byte);
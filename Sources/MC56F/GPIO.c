@@ -242,18 +242,31 @@ void GPIO_Output(GPIO aDesc, uint8_t aVal)
     {
         uint16_t           lB;
         volatile PortRegs* lR;
+        volatile uint16_t  lSR;
 
         lB = 1 << aDesc.mBit;
         lR = PORT_REGS + aDesc.mPort;
 
-        if (aVal)
+        // The data register has no set and clear registers. It is modified
+        // with the interrupts disabled, so an interrupt handler can change
+        // another bit of the same port, the RS-485 driver enable of the
+        // Modbus modules for example. Same sequence as EnterCritical and
+        // ExitCritical of Processor Expert.
+        asm(move.w SR,lSR);
+        asm(bfset #0x0300,SR);
+        asm(nop); asm(nop); asm(nop); asm(nop); asm(nop); asm(nop);
         {
-            lR->mData |=   lB;
-        }
-        else
-        {
-            lR->mData &= ~ lB;
+            if (aVal)
+            {
+                lR->mData |=   lB;
+            }
+            else
+            {
+                lR->mData &= ~ lB;
+            }
         }
+        asm(moveu.w lSR,SR);
+        asm(nop); asm(nop);
     }
 }
 
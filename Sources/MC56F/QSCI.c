@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Sources/MC56F/QSCI.c
@@ -22,6 +22,7 @@
 //
 // Project configuration
 // - Define _MC56F84565_
+// - Also add MC56F/Tick.c to the project
 //
 // Processor Expert Configuration
 // - For each used QSCI port
@@ -38,6 +39,7 @@
 // //////////////////////////////////////////////////////////////////////////
 //
 // - Configure input (Rx) and output (Tx) pins using GPIO_InitFunction
+// - Call Tick_Init, the receive path time stamps the received bytes
 
 // ===== C ==================================================================
 #include <stdint.h>
@@ -45,6 +47,7 @@
 
 // ===== Includes ===========================================================
 #include "MC56F_SIM.h"
+#include "Tick.h"
 
 #include "UART.h"
 
@@ -88,6 +91,9 @@ PortRegs;
 #define CTRL1_REIE (0x0020)
 #define CTRL1_TIIE (0x0040)
 #define CTRL1_TEIE (0x0080)
+#define CTRL1_PT   (0x0100) // Odd parity
+#define CTRL1_PE   (0x0200) // Parity enable
+#define CTRL1_M    (0x1000) // 9 bits
 
 typedef struct
 {
@@ -95,9 +101,9 @@ typedef struct
 
     uint16_t mTimeout_ms;
 
-    uint8_t mCount;
-    uint8_t mSize_byte;
-    uint8_t mState;
+    uint16_t mCount;
+    uint16_t mSize_byte;
+    uint8_t  mState;
 }
 HalfContext;
 
@@ -107,7 +113,27 @@ typedef struct
 {
     uint8_t mIndex;
 
+    uint16_t mCharTime_us;
     uint16_t mEnabledInterrupts;
+    uint32_t mRate_bps;
+    uint16_t mRxGap_us;
+    uint16_t mRxLast_us;
+    uint16_t mRxOverruns;
+    uint8_t  mRxQuiet;
+    uint16_t mTxStop; // 0x0100 sends the second stop bit as a 9th data bit
+
+    UART_Callback mRxData;
+    void        * mRxData_Context;
+
+    uint16_t*         mStream; // NULL when not in stream mode
+    uint16_t          mStreamFlags; // Flags of the next stored byte
+    uint16_t          mStreamGap_us;
+    volatile uint16_t mStreamIn ; // Written by the interrupt handler only
+    volatile uint16_t mStreamOut; // Written by UART_Stream_Read only
+    uint16_t          mStreamSize;
+
+    UART_Callback mTxComplete;
+    void        * mTxComplete_Context;
 
     HalfContext mContexts[OP_QTY];
 }
@@ -116,7 +142,24 @@ Context;
 // Constants
 // //////////////////////////////////////////////////////////////////////////
 
-#define WRITE_TIMEOUT_ms_byte (2)
+#define BITS_PER_CHAR (10) // Start, 8 data, Stop
+
+#define CLOCK_Hz (80000000)
+
+#define DEFAULT_RATE_bps (19200)
+
+// mRate is 16 bits and SBR must be at least 1
+#define RATE_MAX_bps (CLOCK_Hz / 16)
+#define RATE_MIN_bps (CLOCK_Hz / (2 * (uint32_t)0xffff) + 1)
+
+#define SILENCE_MAX_us (0x7fff)
+
+// Write timeout / transfer duration
+#define WRITE_TIMEOUT_FACTOR (4)
+
+// The write timeout lasts at least 2 periods of a 10 ms UART_Tick. The
+// first period may be almost over when the write starts.
+#define WRITE_TIMEOUT_MIN_ms (20)
 
 #define QSCI_QTY (3)
 
@@ -146,7 +189,9 @@ static void Receive_Z0(Context* aThis);
 
 static void Send_Z0(Context* aThis);
 
-static void Start_Z0(HalfContext* aThisH, void* aInOut, uint8_t aSize_byte);
+static void Start_Z0(HalfContext* aThisH, void* aInOut, uint16_t aSize_byte);
+
+static void Stream_Z0(Context* aThis, uint8_t aData, uint16_t aNow_us);
 
 // Entry points
 // //////////////////////////////////////////////////////////////////////////
@@ -231,15 +276,21 @@ void UART_Init(uint8_t aIndex)
 
     lR->mCtrl2 = 0x0020; // FIFO_EN 
 
-    // https://www.nxp.com/docs/en/reference-manual/MC56F8458XRM.pdf, page 956
-    // Baud rate = Peripheral bus clock / ( 16 * ( SBR + ( FRAC / 8 ) ) )
+    lThis->mRxGap_us    = 0;
+    lThis->mRxLast_us   = Tick_Now_us();
+    lThis->mRxOverruns  = 0;
+    lThis->mRxQuiet     = 1;
 
-    // = 80 MHz / ( 16 * ( 260 + ( 3 / 8 ) ) )
-    // = 80 MHz / ( 16 * 260.375 )
-    // = 80 MHz / 4166
-    // = 19.2031 bps (0.52 ms/byte)
+    lThis->mRxData         = NULL;
+    lThis->mRxData_Context = NULL;
 
-    lR->mRate = 0x0823; // SBR = 1000 0010 0 = 260, FRAC = 3
+    lThis->mStream = NULL;
+
+    lThis->mTxComplete         = NULL;
+    lThis->mTxComplete_Context = NULL;
+
+    // 19200 bps, 8N1
+    UART_Configure(aIndex, DEFAULT_RATE_bps, UART_PARITY_NONE, 1);
 
     Interrupt_Enable(aIndex);
 }
@@ -249,10 +300,16 @@ void UART_Abort(uint8_t aIndex, uint8_t aOp)
     // assert(QSCI_QTY > aIndex);
     // assert(OP_QTY > aOp);
 
-    HalfContext* lThisH = sContexts[aIndex].mContexts + aOp;
+    Context    * lThis  = sContexts + aIndex;
+    HalfContext* lThisH = lThis->mContexts + aOp;
 
     Interrupt_Disable(aIndex);
     {
+        if (UART_READ == aOp)
+        {
+            lThis->mStream = NULL;
+        }
+
         lThisH->mCount      = 0;
         lThisH->mInOut      = NULL;
         lThisH->mSize_byte  = 0;
@@ -262,6 +319,88 @@ void UART_Abort(uint8_t aIndex, uint8_t aOp)
     Interrupt_Enable(aIndex);
 }
 
+uint16_t UART_CharTime_us(uint8_t aIndex)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    return sContexts[aIndex].mCharTime_us;
+}
+
+void UART_Configure(uint8_t aIndex, uint32_t aRate_bps, uint8_t aParity, uint8_t aStopBits)
+{
+    // assert(QSCI_QTY > aIndex);
+    // assert(RATE_MIN_bps <= aRate_bps);
+    // assert(RATE_MAX_bps >= aRate_bps);
+    // assert(UART_PARITY_ODD >= aParity);
+    // assert((1 == aStopBits) || ((2 == aStopBits) && (UART_PARITY_NONE == aParity)));
+
+    volatile PortRegs* lR    = PORT_REGS + aIndex;
+    Context          * lThis = sContexts + aIndex;
+
+    uint16_t lBits   = BITS_PER_CHAR;
+    uint16_t lCtrl1  = 0;
+    uint16_t lRate;
+    uint16_t lTxStop = 0;
+
+    // https://www.nxp.com/docs/en/reference-manual/MC56F8458XRM.pdf, page 956
+    // Baud rate = Peripheral bus clock / ( 16 * ( SBR + ( FRAC / 8 ) ) )
+    //
+    // mRate = 8 * ( SBR + ( FRAC / 8 ) )
+    //       = Peripheral bus clock / ( 2 * Baud rate ), rounded
+    //
+    // For example, 19200 bps gives 0x0823, SBR = 260 and FRAC = 3, for
+    // 19203 bps.
+    lRate = (uint16_t)((CLOCK_Hz + aRate_bps) / (2 * aRate_bps));
+
+    switch (aParity)
+    {
+    case UART_PARITY_NONE: break;
+
+    // The parity bit is the 9th bit
+    case UART_PARITY_EVEN: lCtrl1 = CTRL1_M | CTRL1_PE           ; lBits++; break;
+    case UART_PARITY_ODD : lCtrl1 = CTRL1_M | CTRL1_PE | CTRL1_PT; lBits++; break;
+
+    // default: assert(false);
+    }
+
+    // The transmitter sends the second stop bit as a 9th data bit at 1.
+    // The receiver ignores it.
+    if (2 == aStopBits)
+    {
+        lCtrl1  = CTRL1_M;
+        lBits++;
+        lTxStop = 0x0100;
+    }
+
+    Interrupt_Disable(aIndex);
+    {
+        lR->mCtrl1 &= ~ (CTRL1_M | CTRL1_PE | CTRL1_PT);
+        lR->mCtrl1 |= lCtrl1;
+        lR->mRate   = lRate;
+
+        lThis->mRate_bps    = CLOCK_Hz / (2 * (uint32_t)lRate);
+        lThis->mCharTime_us = (uint16_t)((1000000 * (uint32_t)lBits + lThis->mRate_bps - 1) / lThis->mRate_bps);
+        lThis->mTxStop      = lTxStop;
+    }
+    Interrupt_Enable(aIndex);
+}
+
+uint16_t UART_Gap_us(uint8_t aIndex)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    Context* lThis = sContexts + aIndex;
+    uint16_t lResult_us;
+
+    Interrupt_Disable(aIndex);
+    {
+        lResult_us = lThis->mRxGap_us;
+    }
+    Interrupt_Enable(aIndex);
+
+    return lResult_us;
+}
+
 uint8_t UART_Idle(uint8_t aIndex, uint8_t aOp)
 {
     // assert(QSCI_QTY > aIndex);
@@ -272,6 +411,43 @@ uint8_t UART_Idle(uint8_t aIndex, uint8_t aOp)
     return STATE_IDLE == lThisH->mState;
 }
 
+uint16_t UART_Overruns(uint8_t aIndex)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    Context* lThis = sContexts + aIndex;
+    uint16_t lResult;
+
+    Interrupt_Disable(aIndex);
+    {
+        lResult = lThis->mRxOverruns;
+    }
+    Interrupt_Enable(aIndex);
+
+    return lResult;
+}
+
+uint32_t UART_Rate_bps(uint8_t aIndex)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    return sContexts[aIndex].mRate_bps;
+}
+
+void UART_SetRxData(uint8_t aIndex, UART_Callback aCallback, void* aContext)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    Context* lThis = sContexts + aIndex;
+
+    Interrupt_Disable(aIndex);
+    {
+        lThis->mRxData         = aCallback;
+        lThis->mRxData_Context = aContext;
+    }
+    Interrupt_Enable(aIndex);
+}
+
 void UART_SetTimeout(uint8_t aIndex, uint8_t aOp, uint16_t aTimeout_ms)
 {
     // assert(QSCI_QTY > aIndex);
@@ -282,7 +458,21 @@ void UART_SetTimeout(uint8_t aIndex, uint8_t aOp, uint16_t aTimeout_ms)
     lThisH->mTimeout_ms = aTimeout_ms;
 }
 
-void UART_Read(uint8_t aIndex, void* aOut, uint8_t aOutSize_byte)
+void UART_SetTxComplete(uint8_t aIndex, UART_Callback aCallback, void* aContext)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    Context* lThis = sContexts + aIndex;
+
+    Interrupt_Disable(aIndex);
+    {
+        lThis->mTxComplete         = aCallback;
+        lThis->mTxComplete_Context = aContext;
+    }
+    Interrupt_Enable(aIndex);
+}
+
+void UART_Read(uint8_t aIndex, void* aOut, uint16_t aOutSize_byte)
 {
     // assert(QSCI_QTY > aIndex);
 
@@ -294,6 +484,7 @@ void UART_Read(uint8_t aIndex, void* aOut, uint8_t aOutSize_byte)
     {
         Start_Z0(lThisR, aOut, aOutSize_byte);
 
+        lThis ->mRxGap_us   = 0;
         lThisR->mState      = STATE_RX;
         lThisR->mTimeout_ms = 0;
 
@@ -304,7 +495,40 @@ void UART_Read(uint8_t aIndex, void* aOut, uint8_t aOutSize_byte)
     Interrupt_Enable(aIndex);
 }
 
-uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint8_t* aCount)
+uint16_t UART_Silence_us(uint8_t aIndex)
+{
+    // assert(QSCI_QTY > aIndex);
+
+    Context* lThis = sContexts + aIndex;
+    uint16_t lLast_us;
+    uint8_t  lQuiet;
+    uint16_t lResult_us;
+
+    Interrupt_Disable(aIndex);
+    {
+        lLast_us = lThis->mRxLast_us;
+        lQuiet   = lThis->mRxQuiet;
+    }
+    Interrupt_Enable(aIndex);
+
+    if (lQuiet)
+    {
+        return SILENCE_MAX_us;
+    }
+
+    lResult_us = Tick_Now_us() - lLast_us;
+
+    // A "negative" value means the time stamp was taken while Tick_Work
+    // was updating its period count.
+    if (SILENCE_MAX_us < lResult_us)
+    {
+        lResult_us = 0;
+    }
+
+    return lResult_us;
+}
+
+uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint16_t* aCount)
 {
     // assert(QSCI_QTY > aIndex);
     // assert(OP_QTY > aOp);
@@ -341,6 +565,70 @@ uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint8_t* aCount)
     return lResult;
 }
 
+uint16_t UART_Stream_Read(uint8_t aIndex, uint16_t* aOut, uint16_t aOutSize)
+{
+    // assert(QSCI_QTY > aIndex);
+    // assert(NULL != aOut);
+
+    Context* lThis  = sContexts + aIndex;
+    uint16_t lOut   = lThis->mStreamOut;
+    uint16_t lCount = 0;
+
+    if (NULL == lThis->mStream)
+    {
+        return 0;
+    }
+
+    while ((aOutSize > lCount) && (lThis->mStreamIn != lOut))
+    {
+        aOut[lCount] = lThis->mStream[lOut];
+        lCount++;
+
+        lOut++;
+        if (lThis->mStreamSize <= lOut)
+        {
+            lOut = 0;
+        }
+    }
+
+    // The entries are copied before the interrupt handler can reuse them
+    lThis->mStreamOut = lOut;
+
+    return lCount;
+}
+
+void UART_Stream_Start(uint8_t aIndex, uint16_t* aBuffer, uint16_t aSize, uint16_t aGap_us)
+{
+    // assert(QSCI_QTY > aIndex);
+    // assert(NULL != aBuffer);
+    // assert(1 < aSize);
+
+    volatile PortRegs* lR     = PORT_REGS + aIndex;
+    Context          * lThis  = sContexts + aIndex;
+    HalfContext      * lThisR = lThis->mContexts + UART_READ;
+
+    Interrupt_Disable(aIndex);
+    {
+        lThisR->mCount      = 0;
+        lThisR->mInOut      = NULL;
+        lThisR->mSize_byte  = 0;
+        lThisR->mState      = STATE_IDLE;
+        lThisR->mTimeout_ms = 0;
+
+        lThis->mStream       = aBuffer;
+        lThis->mStreamFlags  = UART_STREAM_GAP;
+        lThis->mStreamGap_us = aGap_us;
+        lThis->mStreamIn     = 0;
+        lThis->mStreamOut    = 0;
+        lThis->mStreamSize   = aSize;
+
+        lR->mCtrl1 |= 0x4; // RE
+
+        Receive_Z0(lThis);
+    }
+    Interrupt_Enable(aIndex);
+}
+
 void UART_Tick(uint8_t aIndex, uint8_t aOp, uint16_t aPeriod_ms)
 {
     // assert(QSCI_QTY > aIndex);
@@ -348,6 +636,12 @@ void UART_Tick(uint8_t aIndex, uint8_t aOp, uint16_t aPeriod_ms)
 
     HalfContext* lThisH = sContexts[aIndex].mContexts + aOp;
 
+    // Remember long silences before the time stamp wraps around
+    if ((UART_READ == aOp) && ((SILENCE_MAX_us / 2) <= UART_Silence_us(aIndex)))
+    {
+        sContexts[aIndex].mRxQuiet = 1;
+    }
+
     switch (lThisH->mState)
     {
     case STATE_COMPLETED:
@@ -376,7 +670,7 @@ void UART_Tick(uint8_t aIndex, uint8_t aOp, uint16_t aPeriod_ms)
     }
 }
 
-void UART_Write(uint8_t aIndex, const void* aIn, uint8_t aInSize_byte)
+void UART_Write(uint8_t aIndex, const void* aIn, uint16_t aInSize_byte)
 {
     // assert(QSCI_QTY > aIndex);
 
@@ -389,7 +683,12 @@ void UART_Write(uint8_t aIndex, const void* aIn, uint8_t aInSize_byte)
         Start_Z0(lThisW, (void*) aIn, aInSize_byte);
 
         lThisW->mState      = STATE_TX;
-        lThisW->mTimeout_ms = (uint16_t)(WRITE_TIMEOUT_ms_byte * aInSize_byte);
+        lThisW->mTimeout_ms = (uint16_t)((WRITE_TIMEOUT_FACTOR * (uint32_t)lThis->mCharTime_us * aInSize_byte) / 1000 + 1);
+
+        if (WRITE_TIMEOUT_MIN_ms > lThisW->mTimeout_ms)
+        {
+            lThisW->mTimeout_ms = WRITE_TIMEOUT_MIN_ms;
+        }
 
         lR->mCtrl1 |= 0x8; // TE
 
@@ -446,6 +745,12 @@ void Interrupt_RCV_Z0(Context* aThis)
     uint16_t lDummy = lR->mStatus;
 
     Receive_Z0(aThis);
+
+    // The consumer may respond without waiting for the main loop
+    if (NULL != aThis->mRxData)
+    {
+        aThis->mRxData(aThis->mRxData_Context);
+    }
 }
 
 void Interrupt_RERR_Z0(Context* aThis)
@@ -459,7 +764,19 @@ void Interrupt_RERR_Z0(Context* aThis)
 
     if (0 != (lStatus & 0x0f00)) // OR NF FE PF
     {
-        lThisR->mState = STATE_ERROR;
+        if (NULL != aThis->mStream)
+        {
+            aThis->mStreamFlags |= UART_STREAM_ERROR;
+        }
+        else if (STATE_IDLE != lThisR->mState)
+        {
+            lThisR->mState = STATE_ERROR;
+        }
+    }
+
+    if (0 != (lStatus & 0x0800)) // OR
+    {
+        aThis->mRxOverruns++;
     }
 
     if (0 != (lStatus & 0x0f00))
@@ -480,6 +797,12 @@ void Interrupt_TIDLE_Z0(Context* aThis)
 
     aThis->mEnabledInterrupts &= ~ CTRL1_TIIE;
 
+    // The RS-485 driver is released without waiting for the main loop
+    if (NULL != aThis->mTxComplete)
+    {
+        aThis->mTxComplete(aThis->mTxComplete_Context);
+    }
+
     Interrupt_Enable(aThis->mIndex);
 }
 
@@ -503,6 +826,8 @@ void Receive_Z0(Context* aThis)
     volatile PortRegs* lR     = PORT_REGS + aThis->mIndex;
     HalfContext      * lThisR = aThis->mContexts + UART_READ;
 
+    uint16_t lNow_us = Tick_Now_us();
+
     for (;;)
     {
         uint16_t lCtrl2 = lR->mCtrl2;
@@ -522,16 +847,45 @@ void Receive_Z0(Context* aThis)
         {
             uint8_t lData = (uint8_t)lR->mData;
 
-            if (NULL == lThisR->mInOut)
+            if (NULL != aThis->mStream)
             {
-                lThisR->mState = STATE_ERROR;
+                Stream_Z0(aThis, lData, lNow_us);
             }
             else
             {
-                lThisR->mInOut[lThisR->mCount] = lData;
-
-                IncCount_Z0(lThisR, STATE_COMPLETED, 0);
+                // The bytes already waiting in the FIFO get the same time
+                // stamp, so the measured gap is never longer than the real
+                // one.
+                if ((0 < lThisR->mCount) && (! aThis->mRxQuiet))
+                {
+                    uint16_t lGap_us = lNow_us - aThis->mRxLast_us;
+
+                    if ((0x8000 > lGap_us) && (aThis->mRxGap_us < lGap_us))
+                    {
+                        aThis->mRxGap_us = lGap_us;
+                    }
+                }
+
+                if (NULL == lThisR->mInOut)
+                {
+                    // The bytes received while no read is pending, after
+                    // UART_Abort for example, are dropped. Only a read
+                    // receiving more bytes than its buffer fails.
+                    if (STATE_IDLE != lThisR->mState)
+                    {
+                        lThisR->mState = STATE_ERROR;
+                    }
+                }
+                else
+                {
+                    lThisR->mInOut[lThisR->mCount] = lData;
+
+                    IncCount_Z0(lThisR, STATE_COMPLETED, 0);
+                }
             }
+
+            aThis->mRxLast_us = lNow_us;
+            aThis->mRxQuiet   = 0;
         }
     }
 }
@@ -556,7 +910,7 @@ void Send_Z0(Context* aThis)
 
     for (i = 0; i < lCtrl2; i++)
     {
-        lR->mData = lThisW->mInOut[lThisW->mCount];
+        lR->mData = lThisW->mInOut[lThisW->mCount] | aThis->mTxStop;
 
         IncCount_Z0(lThisW, STATE_TX_WAIT, 50);
     }
@@ -572,7 +926,7 @@ void Send_Z0(Context* aThis)
     }
 }
 
-void Start_Z0(HalfContext* aThisH, void* aInOut, uint8_t aSize_byte)
+void Start_Z0(HalfContext* aThisH, void* aInOut, uint16_t aSize_byte)
 {
     // assert(NULL != aInOut);
     // assert(0 < aSize_byte);
@@ -581,3 +935,34 @@ void Start_Z0(HalfContext* aThisH, void* aInOut, uint8_t aSize_byte)
     aThisH->mInOut     = aInOut;
     aThisH->mSize_byte = aSize_byte;
 }
+
+void Stream_Z0(Context* aThis, uint8_t aData, uint16_t aNow_us)
+{
+    // assert(NULL != aThis->mStream);
+
+    uint16_t lGap_us = aNow_us - aThis->mRxLast_us;
+    uint16_t lIn     = aThis->mStreamIn;
+    uint16_t lNext   = lIn + 1;
+
+    if ((aThis->mRxQuiet) || ((0x8000 > lGap_us) && (aThis->mStreamGap_us <= lGap_us)))
+    {
+        aThis->mStreamFlags |= UART_STREAM_GAP;
+    }
+
+    if (aThis->mStreamSize <= lNext)
+    {
+        lNext = 0;
+    }
+
+    // The consumer knows bytes are missing when it reads the next one
+    if (aThis->mStreamOut == lNext)
+    {
+        aThis->mRxOverruns++;
+        aThis->mStreamFlags |= UART_STREAM_ERROR;
+        return;
+    }
+
+    aThis->mStream[lIn] = aData | aThis->mStreamFlags;
+    aThis->mStreamIn    = lNext;
+    aThis->mStreamFlags = 0;
+}
@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Sources/MC56F/Tick.c
@@ -53,6 +53,8 @@ PIT_Regs;
 
 #define PERIOD_ms (10)
 
+#define PERIOD_us (PERIOD_ms * 1000)
+
 static volatile PIT_Regs* PIT1_REGS = (PIT_Regs*)0x0000E110;
 
 #define SIM_PCE2_PIT1 (0x0004)
@@ -60,7 +62,8 @@ static volatile PIT_Regs* PIT1_REGS = (PIT_Regs*)0x0000E110;
 // Variables
 // //////////////////////////////////////////////////////////////////////////
 
-static uint16_t sStats;
+static uint16_t sModulo;
+static uint16_t sStats; // Number of elapsed periods
 
 // Functions
 // //////////////////////////////////////////////////////////////////////////
@@ -82,8 +85,10 @@ void Tick_Init(uint32_t aClock_Hz)
 
     *SIM_PCE2 |= SIM_PCE2_PIT1;
 
+    sModulo = (uint16_t)lCount;
+
     PIT1_REGS->mControl = (uint16_t)(lPrescaler << 3);
-    PIT1_REGS->mModulo  = (uint16_t) lCount;
+    PIT1_REGS->mModulo  = sModulo;
 
     PIT1_REGS->mControl = (uint16_t)(lPrescaler << 3) | PIT_CTRL_CNT_EN;
 }
@@ -97,12 +102,37 @@ uint16_t Tick_Work()
     {
         lResult_ms = PERIOD_ms;
 
+        // sStats is incremented before clearing the flag. An interrupt
+        // calling Tick_Now_us between the two operations sees a time in
+        // advance by one period, never a time going backward by one
+        // period.
+        sStats++;
+
         lControl &= ~ PIT_CTRL_PRF;
 
         PIT1_REGS->mControl = lControl;
-
-        sStats++;
     }
 
     return lResult_ms;
 }
+
+uint16_t Tick_Now_us()
+{
+    uint16_t lControl = PIT1_REGS->mControl;
+    uint16_t lCounter = PIT1_REGS->mCounter;
+    uint16_t lPeriods = sStats;
+
+    if (0 != (lControl & PIT_CTRL_PRF))
+    {
+        // The period is completed but Tick_Work did not process it yet
+        lPeriods++;
+    }
+    else if (0 != (PIT1_REGS->mControl & PIT_CTRL_PRF))
+    {
+        // The counter rolled over between the two first reads
+        lCounter = PIT1_REGS->mCounter;
+        lPeriods++;
+    }
+
+    return (uint16_t)(lPeriods * PERIOD_us) + (uint16_t)(((uint32_t)lCounter * PERIOD_us) / sModulo);
+}
@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Sources/Modbus_CRC.c
@@ -26,13 +26,13 @@
 // Functions
 // //////////////////////////////////////////////////////////////////////////
 
-void Modbus_CRC_Compute_Buffer(uint8_t* aInOut, uint8_t aInSize_byte)
+void Modbus_CRC_Compute_Buffer(uint8_t* aInOut, uint16_t aInSize_byte)
 {
     // assert(0 < aInSize_byte);
 
     Modbus_CRC lCRC;
 
-    uint8_t i;
+    uint16_t i;
 
     Modbus_CRC_Init(&lCRC);
 
@@ -44,14 +44,14 @@ void Modbus_CRC_Compute_Buffer(uint8_t* aInOut, uint8_t aInSize_byte)
     Modbus_CRC_Get(&lCRC, aInOut + aInSize_byte);
 }
 
-uint8_t Modbus_CRC_Verify_Buffer(const uint8_t* aIn, uint8_t aInSize_byte)
+uint8_t Modbus_CRC_Verify_Buffer(const uint8_t* aIn, uint16_t aInSize_byte)
 {
     // assert(2 < aInSize_byte);
 
     Modbus_CRC lCRC;
-    uint8_t    lInSize_byte = aInSize_byte - sizeof(uint16_t);
+    uint16_t   lInSize_byte = aInSize_byte - sizeof(uint16_t);
 
-    uint8_t i;
+    uint16_t i;
 
     Modbus_CRC_Init(&lCRC);
 
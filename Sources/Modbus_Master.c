@@ -0,0 +1,701 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Sources/Modbus_Master.c
+
+// References
+// //////////////////////////////////////////////////////////////////////////
+//
+// MODBUS APPLICATION PROTOCOL SPECIFICATION V1.1b3
+// https://modbus.org/docs/Modbus_Application_Protocol_V1_1b3.pdf
+//
+// MODBUS over Serial Line Specification and Implementation Guide V1.02
+// https://modbus.org/docs/Modbus_over_serial_line_V1_02.pdf
+
+// Assumptions
+// //////////////////////////////////////////////////////////////////////////
+//
+// - Modbus_Master_Submit, Modbus_Master_Tick and Modbus_Master_Work are
+//   called from the same context.
+
+// CodeWarrior
+// //////////////////////////////////////////////////////////////////////////
+//
+// Project configuration
+// - Also add Modbus_CRC.c to the project
+// - Also add MC56F/QSCI.c to the project
+// - Also add MC56F/Tick.c to the project
+
+// Code
+// //////////////////////////////////////////////////////////////////////////
+//
+// - Call Tick_Init, the silence between frames is measured using the time
+//   stamps of the received bytes
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus_CRC.h"
+#include "UART.h"
+
+#include "Modbus_Master.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define BACKOFF_MIN_ms (100)
+#define BACKOFF_MAX_ms (1000)
+
+#define DEFAULT_RETRY_MAX  (2)
+#define DEFAULT_TIMEOUT_ms (100)
+
+// MODBUS over Serial Line Specification and Implementation Guide V1.02
+// 2.5.1.1 - Above 19200 bps, a fixed value is used for t3.5.
+// UART_Rate_bps returns the rate the UART generates, 19203 bps when
+// 19200 bps is requested for example, so the limit has a 1 % margin.
+#define FIXED_TIMES_bps (19392) // 19200 bps + 1 %
+#define FIXED_T35_us    (1750)
+
+// Device, Function, Exception, CRC
+#define EXCEPTION_SIZE_byte (5)
+
+// --> INIT <-------------------+
+//     |                        |
+//     +--> IDLE <===+======+   |
+//          |        |      |   |
+//          +--> WRITING    |   |
+//               |   |      |   |
+//               |   +--> READING
+//               |              |
+//               +==> ERROR ----+
+#define STATE_ERROR   (0)
+#define STATE_IDLE    (1)
+#define STATE_INIT    (2)
+#define STATE_READING (3)
+#define STATE_WRITING (4)
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Complete(Modbus_Master* aThis, uint8_t aResult);
+
+// Return  0      Invalid request
+//         Other  Size of the request including the CRC, in byte
+static uint16_t Frame_Build(Modbus_Master* aThis, Modbus_Master_Request* aRequest);
+
+// Return  false  aRequest is a submitted request
+//         true   aRequest is part of the poll list
+static uint8_t IsPolled(Modbus_Master* aThis, Modbus_Master_Request* aRequest);
+
+static void Prepare(Modbus_Master* aThis);
+
+// aSize_byte  Size of the received frame, including the CRC
+static void Receive(Modbus_Master* aThis, uint16_t aSize_byte);
+
+// Return  MODBUS_NO_ERROR
+//         MODBUS_EXCEPTION_...
+//         MODBUS_MASTER_TIMEOUT  Invalid response
+static uint8_t Response_Parse(Modbus_Master* aThis, uint16_t aSize_byte);
+
+static void Retry(Modbus_Master* aThis);
+
+// Return  NULL   No request is due
+//         Other  The next request to send
+static Modbus_Master_Request* Select(Modbus_Master* aThis);
+
+static void Set_IDLE(Modbus_Master* aThis);
+
+// Interrupt context
+// aContext  The Modbus_Master instance
+static void TxComplete(void* aContext);
+
+static void Work_IDLE   (Modbus_Master* aThis);
+static void Work_READING(Modbus_Master* aThis);
+static void Work_WRITING(Modbus_Master* aThis);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Modbus_Master_Init(Modbus_Master* aThis, uint8_t aUART, Modbus_Master_Request* aRequests, uint8_t aRequestQty, GPIO aOutputEnable)
+{
+    // assert(NULL != aThis);
+    // assert((NULL != aRequests) || (0 == aRequestQty));
+
+    unsigned int i;
+
+    aThis->mCurrent      = NULL;
+
+    aThis->mForward.mFrame       = NULL;
+    aThis->mForward.mOnCompleted = NULL;
+    aThis->mForward.mResult      = MODBUS_NO_ERROR;
+
+    aThis->mOutputEnable = aOutputEnable;
+    aThis->mQueue        = NULL;
+    aThis->mRequests     = aRequests;
+    aThis->mRequestQty   = aRequestQty;
+    aThis->mRetryMax     = DEFAULT_RETRY_MAX;
+    aThis->mSize_byte    = 0;
+    aThis->mState        = STATE_INIT;
+    aThis->mTimeout_ms   = DEFAULT_TIMEOUT_ms;
+    aThis->mUART         = aUART;
+
+    // The poll list requests are due immediately
+    for (i = 0; i < aRequestQty; i++)
+    {
+        aRequests[i].mBackOff_ms = 0;
+        aRequests[i].mElapsed_ms = aRequests[i].mPeriod_ms;
+        aRequests[i].mResult     = MODBUS_MASTER_PENDING;
+        aRequests[i].mRetries    = 0;
+    }
+
+    aThis->mOutputEnable.mOutput        = 1;
+    aThis->mOutputEnable.mSlewRate_Slow = 1;
+
+    UART_Init(aUART);
+    UART_SetTxComplete(aUART, TxComplete, aThis);
+
+    GPIO_Output(aThis->mOutputEnable, 0);
+}
+
+uint8_t Modbus_Master_Forward(void* aContext, uint8_t* aFrame, uint16_t* aSize_byte, uint16_t aBufferSize_byte)
+{
+    // assert(NULL != aContext);
+    // assert(NULL != aFrame);
+    // assert(NULL != aSize_byte);
+
+    Modbus_Master        * lThis = aContext;
+    Modbus_Master_Request* lR    = &lThis->mForward;
+
+    if (NULL == lR->mFrame)
+    {
+        lR->mDevice         = aFrame[MODBUS_BYTE_DEVICE];
+        lR->mFrame          = aFrame;
+        lR->mFrameMax_byte  = aBufferSize_byte;
+        lR->mFrameSize_byte = *aSize_byte;
+
+        Modbus_Master_Submit(lThis, lR);
+    }
+
+    if (MODBUS_MASTER_PENDING == lR->mResult)
+    {
+        return MODBUS_MASTER_PENDING;
+    }
+
+    lR->mFrame = NULL;
+
+    if (MODBUS_NO_ERROR != lR->mResult)
+    {
+        return MODBUS_EXCEPTION_GATEWAY_TARGET_DEVICE_FAILED_TO_RESPOND;
+    }
+
+    *aSize_byte = lR->mFrameSize_byte;
+
+    return MODBUS_NO_ERROR;
+}
+
+void Modbus_Master_InitRetry(Modbus_Master* aThis, uint16_t aTimeout_ms, uint8_t aRetryMax)
+{
+    // assert(NULL != aThis);
+    // assert(0 < aTimeout_ms);
+
+    aThis->mRetryMax   = aRetryMax;
+    aThis->mTimeout_ms = aTimeout_ms;
+}
+
+void Modbus_Master_Submit(Modbus_Master* aThis, Modbus_Master_Request* aRequest)
+{
+    // assert(NULL != aThis);
+    // assert(NULL != aRequest);
+
+    Modbus_Master_Request** lTail = &aThis->mQueue;
+
+    aRequest->mNext    = NULL;
+    aRequest->mResult  = MODBUS_MASTER_PENDING;
+    aRequest->mRetries = 0;
+
+    while (NULL != *lTail)
+    {
+        lTail = &(*lTail)->mNext;
+    }
+
+    *lTail = aRequest;
+}
+
+void Modbus_Master_Tick(Modbus_Master* aThis, uint16_t aPeriod_ms)
+{
+    // assert(NULL != aThis);
+    // assert(0 < aPeriod_ms);
+
+    unsigned int i;
+
+    for (i = 0; i < aThis->mRequestQty; i++)
+    {
+        Modbus_Master_Request* lR = aThis->mRequests + i;
+
+        if (0xffff - aPeriod_ms > lR->mElapsed_ms)
+        {
+            lR->mElapsed_ms += aPeriod_ms;
+        }
+    }
+
+    switch (aThis->mState)
+    {
+    case STATE_ERROR: aThis->mState = STATE_INIT; break;
+
+    case STATE_INIT: Set_IDLE(aThis); break;
+
+    case STATE_IDLE:
+    case STATE_READING:
+        UART_Tick(aThis->mUART, UART_READ, aPeriod_ms);
+        break;
+
+    case STATE_WRITING:
+        UART_Tick(aThis->mUART, UART_WRITE, aPeriod_ms);
+        break;
+
+    // default: assert(false);
+    }
+}
+
+void Modbus_Master_Work(Modbus_Master* aThis)
+{
+    // assert(NULL != aThis);
+
+    switch (aThis->mState)
+    {
+    case STATE_ERROR:
+    case STATE_INIT: break;
+
+    case STATE_IDLE   : Work_IDLE   (aThis); break;
+    case STATE_READING: Work_READING(aThis); break;
+    case STATE_WRITING: Work_WRITING(aThis); break;
+
+    // default: assert(false);
+    }
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Complete(Modbus_Master* aThis, uint8_t aResult)
+{
+    // assert(NULL != aThis->mCurrent);
+
+    Modbus_Master_Request* lR = aThis->mCurrent;
+
+    aThis->mCurrent = NULL;
+
+    if (IsPolled(aThis, lR))
+    {
+        if (MODBUS_MASTER_TIMEOUT == aResult)
+        {
+            // Do not let an absent device use the bus
+            if (0 == lR->mBackOff_ms)
+            {
+                lR->mBackOff_ms = BACKOFF_MIN_ms;
+            }
+            else if ((BACKOFF_MAX_ms / 2) >= lR->mBackOff_ms)
+            {
+                lR->mBackOff_ms *= 2;
+            }
+            else
+            {
+                lR->mBackOff_ms = BACKOFF_MAX_ms;
+            }
+        }
+        else
+        {
+            lR->mBackOff_ms = 0;
+        }
+
+        lR->mElapsed_ms = 0;
+    }
+
+    lR->mResult  = aResult;
+    lR->mRetries = 0;
+
+    if (NULL != lR->mOnCompleted)
+    {
+        lR->mOnCompleted(lR);
+    }
+}
+
+// Device Function Address ...
+uint16_t Frame_Build(Modbus_Master* aThis, Modbus_Master_Request* aRequest)
+{
+    uint8_t* lB           = aThis->mBuffer;
+    uint16_t lCount       = aRequest->mCount;
+    uint16_t lResult_byte = 1 + 1 + sizeof(uint16_t); // Device, Function, Address
+
+    unsigned int i;
+
+    if (NULL != aRequest->mFrame)
+    {
+        if ((4 > aRequest->mFrameSize_byte) || (sizeof(aThis->mBuffer) < aRequest->mFrameSize_byte))
+        {
+            return 0;
+        }
+
+        memcpy(lB, aRequest->mFrame, aRequest->mFrameSize_byte);
+
+        // The end of the response is detected using the silence
+        aThis->mExpected_byte = sizeof(aThis->mBuffer);
+
+        return aRequest->mFrameSize_byte;
+    }
+
+    lB[MODBUS_BYTE_DEVICE  ] = aRequest->mDevice;
+    lB[MODBUS_BYTE_FUNCTION] = aRequest->mFunction;
+    lB[2] = (uint8_t)(aRequest->mAddress >> 8);
+    lB[3] = (uint8_t) aRequest->mAddress;
+
+    switch (aRequest->mFunction)
+    {
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+    case MODBUS_FUNCTION_READ_INPUT_REGISTERS  :
+        if ((0 == lCount) || (MODBUS_READ_REGISTERS_MAX < lCount))
+        {
+            return 0;
+        }
+
+        lB[4] = (uint8_t)(lCount >> 8);
+        lB[5] = (uint8_t) lCount;
+        lResult_byte += sizeof(uint16_t); // Count
+
+        // Device, Function, ByteCount, Data, CRC
+        aThis->mExpected_byte = 1 + 1 + 1 + sizeof(uint16_t) * lCount + sizeof(uint16_t);
+        break;
+
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER:
+        if (1 != lCount)
+        {
+            return 0;
+        }
+
+        lB[4] = (uint8_t)(aRequest->mData[0] >> 8);
+        lB[5] = (uint8_t) aRequest->mData[0];
+        lResult_byte += sizeof(uint16_t); // Value
+
+        // Echo of the request
+        aThis->mExpected_byte = lResult_byte + sizeof(uint16_t);
+        break;
+
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS:
+        if ((0 == lCount) || (MODBUS_WRITE_REGISTERS_MAX < lCount))
+        {
+            return 0;
+        }
+
+        lB[4] = (uint8_t)(lCount >> 8);
+        lB[5] = (uint8_t) lCount;
+        lB[6] = (uint8_t)(sizeof(uint16_t) * lCount);
+        lResult_byte += sizeof(uint16_t) + 1; // Count, ByteCount
+
+        for (i = 0; i < lCount; i++)
+        {
+            lB[lResult_byte    ] = (uint8_t)(aRequest->mData[i] >> 8);
+            lB[lResult_byte + 1] = (uint8_t) aRequest->mData[i];
+
+            lResult_byte += sizeof(uint16_t);
+        }
+
+        // Device, Function, Address, Count, CRC
+        aThis->mExpected_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t);
+        break;
+
+    default: return 0;
+    }
+
+    Modbus_CRC_Compute_Buffer(lB, lResult_byte);
+
+    return lResult_byte + sizeof(uint16_t); // CRC
+}
+
+uint8_t IsPolled(Modbus_Master* aThis, Modbus_Master_Request* aRequest)
+{
+    return (aThis->mRequests <= aRequest) && ((aThis->mRequests + aThis->mRequestQty) > aRequest);
+}
+
+void Prepare(Modbus_Master* aThis)
+{
+    while (NULL == aThis->mCurrent)
+    {
+        Modbus_Master_Request* lR = Select(aThis);
+        if (NULL == lR)
+        {
+            break;
+        }
+
+        // assert(0 < lR->mDevice);
+
+        aThis->mCurrent   = lR;
+        aThis->mSize_byte = Frame_Build(aThis, lR);
+        if (0 == aThis->mSize_byte)
+        {
+            Complete(aThis, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+        }
+    }
+}
+
+void Receive(Modbus_Master* aThis, uint16_t aSize_byte)
+{
+    uint8_t lResult = Response_Parse(aThis, aSize_byte);
+
+    if (MODBUS_MASTER_TIMEOUT == lResult)
+    {
+        Retry(aThis);
+    }
+    else
+    {
+        Complete(aThis, lResult);
+        Set_IDLE(aThis);
+    }
+}
+
+uint8_t Response_Parse(Modbus_Master* aThis, uint16_t aSize_byte)
+{
+    const uint8_t        * lB = aThis->mBuffer;
+    Modbus_Master_Request* lR = aThis->mCurrent;
+
+    unsigned int i;
+
+    if ((!Modbus_CRC_Verify_Buffer(lB, aSize_byte)) || (lR->mDevice != lB[MODBUS_BYTE_DEVICE]))
+    {
+        return MODBUS_MASTER_TIMEOUT;
+    }
+
+    if (NULL != lR->mFrame)
+    {
+        if (lR->mFrameMax_byte < aSize_byte)
+        {
+            return MODBUS_MASTER_TIMEOUT;
+        }
+
+        memcpy(lR->mFrame, lB, aSize_byte);
+
+        lR->mFrameSize_byte = aSize_byte;
+
+        return MODBUS_NO_ERROR;
+    }
+
+    if ((lR->mFunction | MODBUS_FUNCTION_ERROR) == lB[MODBUS_BYTE_FUNCTION])
+    {
+        return lB[MODBUS_BYTE_EXCEPTION];
+    }
+
+    if (lR->mFunction != lB[MODBUS_BYTE_FUNCTION])
+    {
+        return MODBUS_MASTER_TIMEOUT;
+    }
+
+    switch (lR->mFunction)
+    {
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+    case MODBUS_FUNCTION_READ_INPUT_REGISTERS  :
+        if ((sizeof(uint16_t) * lR->mCount) != lB[2])
+        {
+            return MODBUS_MASTER_TIMEOUT;
+        }
+
+        for (i = 0; i < lR->mCount; i++)
+        {
+            uint16_t lValue = lB[3 + sizeof(uint16_t) * i];
+
+            lValue <<= 8;
+            lValue |= lB[4 + sizeof(uint16_t) * i];
+
+            lR->mData[i] = lValue;
+        }
+        break;
+
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER:
+        // Echo of the request
+        if ((lB[2] != (uint8_t)(lR->mAddress >> 8)) || (lB[3] != (uint8_t)lR->mAddress)
+            || (lB[4] != (uint8_t)(lR->mData[0] >> 8)) || (lB[5] != (uint8_t)lR->mData[0]))
+        {
+            return MODBUS_MASTER_TIMEOUT;
+        }
+        break;
+
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS:
+        if ((lB[2] != (uint8_t)(lR->mAddress >> 8)) || (lB[3] != (uint8_t)lR->mAddress)
+            || (lB[4] != (uint8_t)(lR->mCount >> 8)) || (lB[5] != (uint8_t)lR->mCount))
+        {
+            return MODBUS_MASTER_TIMEOUT;
+        }
+        break;
+
+    // default: assert(false);
+    }
+
+    return MODBUS_NO_ERROR;
+}
+
+void Retry(Modbus_Master* aThis)
+{
+    // assert(NULL != aThis->mCurrent);
+
+    Modbus_Master_Request* lR = aThis->mCurrent;
+
+    if (aThis->mRetryMax > lR->mRetries)
+    {
+        lR->mRetries++;
+
+        // The response overwrote the request
+        aThis->mSize_byte = Frame_Build(aThis, lR);
+    }
+    else
+    {
+        Complete(aThis, MODBUS_MASTER_TIMEOUT);
+    }
+
+    aThis->mState = STATE_IDLE;
+
+    Prepare(aThis);
+}
+
+Modbus_Master_Request* Select(Modbus_Master* aThis)
+{
+    Modbus_Master_Request* lResult = aThis->mQueue;
+    uint16_t               lLate_ms = 0;
+
+    unsigned int i;
+
+    if (NULL != lResult)
+    {
+        aThis->mQueue = lResult->mNext;
+        return lResult;
+    }
+
+    for (i = 0; i < aThis->mRequestQty; i++)
+    {
+        Modbus_Master_Request* lR = aThis->mRequests + i;
+        uint32_t               lDue_ms = (uint32_t)lR->mPeriod_ms + lR->mBackOff_ms;
+
+        if (lDue_ms <= lR->mElapsed_ms)
+        {
+            uint16_t lL_ms = (uint16_t)(lR->mElapsed_ms - lDue_ms);
+
+            // Lowest priority value first, then the latest request
+            if ((NULL == lResult) || (lResult->mPriority > lR->mPriority)
+                || ((lResult->mPriority == lR->mPriority) && (lLate_ms < lL_ms)))
+            {
+                lLate_ms = lL_ms;
+                lResult  = lR;
+            }
+        }
+    }
+
+    return lResult;
+}
+
+void Set_IDLE(Modbus_Master* aThis)
+{
+    if (FIXED_TIMES_bps < UART_Rate_bps(aThis->mUART))
+    {
+        aThis->mT35_us = FIXED_T35_us;
+    }
+    else
+    {
+        aThis->mT35_us = (7 * UART_CharTime_us(aThis->mUART)) / 2;
+    }
+
+    aThis->mState = STATE_IDLE;
+
+    Prepare(aThis);
+}
+
+void TxComplete(void* aContext)
+{
+    Modbus_Master* lThis = (Modbus_Master*)aContext;
+
+    // GPIO_Output is interrupt safe, the application may use the other
+    // bits of the port.
+    GPIO_Output(lThis->mOutputEnable, 0);
+
+    UART_Read      (lThis->mUART, lThis->mBuffer, lThis->mExpected_byte);
+    UART_SetTimeout(lThis->mUART, UART_READ, lThis->mTimeout_ms);
+}
+
+void Work_IDLE(Modbus_Master* aThis)
+{
+    Prepare(aThis);
+
+    // The next request goes out as soon as the line is silent for t3.5
+    if ((NULL != aThis->mCurrent) && (aThis->mT35_us <= UART_Silence_us(aThis->mUART)))
+    {
+        GPIO_Output(aThis->mOutputEnable, 1);
+
+        UART_Write(aThis->mUART, aThis->mBuffer, aThis->mSize_byte);
+
+        aThis->mState = STATE_WRITING;
+    }
+}
+
+void Work_READING(Modbus_Master* aThis)
+{
+    uint16_t lCount;
+
+    switch (UART_Status(aThis->mUART, UART_READ, &lCount))
+    {
+    case UART_ERROR: Retry(aThis); break; // Timeout or invalid character
+
+    case UART_PENDING:
+        if (NULL != aThis->mCurrent->mFrame)
+        {
+            // The size of a forwarded response is not known
+            if ((0 < lCount) && (aThis->mT35_us <= UART_Silence_us(aThis->mUART)))
+            {
+                UART_Abort(aThis->mUART, UART_READ);
+
+                Receive(aThis, lCount);
+            }
+        }
+        // An exception response is shorter than the expected response
+        else if ((EXCEPTION_SIZE_byte <= lCount) && (0 != (aThis->mBuffer[MODBUS_BYTE_FUNCTION] & MODBUS_FUNCTION_ERROR)))
+        {
+            UART_Abort(aThis->mUART, UART_READ);
+
+            Receive(aThis, EXCEPTION_SIZE_byte);
+        }
+        break;
+
+    case UART_SUCCESS:
+        Receive(aThis, aThis->mExpected_byte);
+        break;
+
+    // default: assert(false);
+    }
+}
+
+void Work_WRITING(Modbus_Master* aThis)
+{
+    uint16_t lCount;
+
+    switch (UART_Status(aThis->mUART, UART_WRITE, &lCount))
+    {
+    case UART_ERROR:
+        GPIO_Output(aThis->mOutputEnable, 0);
+
+        // The failed write counts as a retry, the request completes with
+        // MODBUS_MASTER_TIMEOUT after the last one. The next request
+        // waits for Modbus_Master_Tick to leave STATE_ERROR.
+        Retry(aThis);
+        aThis->mState = STATE_ERROR;
+        break;
+
+    case UART_PENDING: break;
+
+    case UART_SUCCESS:
+        // TxComplete already released the output and started the read
+        aThis->mState = STATE_READING;
+        break;
+
+    // default: assert(false);
+    }
+}
@@ -1,6 +1,6 @@
 
 // Author    KMS - Martin Dubois, P. Eng.
-// Copyright (C) 2024 KMS
+// Copyright (C) 2024-2026 KMS
 // License   http://www.apache.org/licenses/LICENSE-2.0
 // Product   KMS-uC
 // File      Sources/Modbus_Slave.c
@@ -23,13 +23,19 @@
 // Project configuration
 // - Also add Modbus_CRC.c to the project
 // - Also add MC56F/QSCI.c to the project
+// - Also add MC56F/Tick.c to the project
+// - Optionally define MODBUS_SLAVE_BUFFER_SIZE_byte to reduce the RAM usage
+// - Optionally define MODBUS_SLAVE_STREAM_SIZE to reduce the RAM usage
 
 // Code
 // //////////////////////////////////////////////////////////////////////////
+//
+// - Call Tick_Init, the frames are delimited using the silence on the line
 
 // ===== C ==================================================================
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 // ===== Includes ===========================================================
 #include "Modbus.h"
@@ -41,547 +47,2577 @@
 // Configuration
 // //////////////////////////////////////////////////////////////////////////
 
-#define TIMEOUT_ms (500)
+// MODBUS_SLAVE_BUFFER_SIZE_byte  Size of the request and response buffer,
+//                                including device address and CRC. The
+//                                default is the maximum RTU frame size. The
+//                                maximum register count per request is
+//                                reduced when a smaller buffer is used.
+#ifndef MODBUS_SLAVE_BUFFER_SIZE_byte
+    #define MODBUS_SLAVE_BUFFER_SIZE_byte (MODBUS_ADU_MAX_byte)
+#endif
+
+// MODBUS_SLAVE_STREAM_SIZE  Number of entries of the RTU receive ring
+//                           buffer, see UART_Stream_Start. The default
+//                           holds a whole request, so Modbus_Slave_Work
+//                           can be late by a frame.
+#ifndef MODBUS_SLAVE_STREAM_SIZE
+    #define MODBUS_SLAVE_STREAM_SIZE (MODBUS_SLAVE_BUFFER_SIZE_byte + 1)
+#endif
 
 // Data types
 // //////////////////////////////////////////////////////////////////////////
 
-// --> INIT
-//     |
-//     +--> WAITING <====+------+
-//          |            |      |
-//          +--> READING |      |
-//               | |     |      |
-//               | +--> WRITING |
-//               |      |       |
-//               +------+==> ERROR
+// --> INIT <-------------------------+
+//     |                              |
+//     +--> RECEIVING <===+----+      |
+//          |             |    |      |
+//          +--> PENDING -+    |      |
+//          |    |             |      |
+//          +----+--> SENDING -+      |
+//                    |               |
+//                    +--> ERROR -----+
+//
+// SENDING goes back to PENDING after sending the pending timeout exception
 typedef enum
 {
-    STATE_ERROR  ,
-    STATE_INIT   ,
-    STATE_READING,
-    STATE_WAITING,
-    STATE_WRITING
+    STATE_ERROR    ,
+    STATE_INIT     ,
+    STATE_PENDING  ,
+    STATE_RECEIVING,
+    STATE_SENDING
 }
 State;
 
 // Constants
 // //////////////////////////////////////////////////////////////////////////
 
-#define UNKNOWN_EXPECTED_COUNT (0xff)
+// MODBUS over Serial Line Specification and Implementation Guide V1.02
+// 2.5.1.1 - Above 19200 bps, fixed values are used for t1.5 and t3.5.
+// UART_Rate_bps returns the rate the UART generates, 19203 bps when
+// 19200 bps is requested for example, so the limit has a 1 % margin.
+#define FIXED_TIMES_bps (19392) // 19200 bps + 1 %
+#define FIXED_T15_us    (750)
+#define FIXED_T35_us    (1750)
+
+#define DEFAULT_PENDING_TIMEOUT_ms (100)
+
+// MODBUS APPLICATION PROTOCOL SPECIFICATION V1.1b3
+// 6.14 - Read File Record
+#define FILE_DATA_MAX_byte  (0xf5) // Byte count of the request and of the response
+#define FILE_RECORD_MAX     (0x270f)
+#define FILE_REFERENCE_TYPE (6)
+
+// Device, Function, Address, Count, CRC
+#define FAST_REQUEST_SIZE_byte (8)
+
+// Value of sRxNext, UART_Stream_Read never returns it
+#define NO_ENTRY (0xffff)
+
+// Upper limit of Modbus_Slave_Counters::mLatency[0]
+#define LATENCY_FIRST_us (500)
+
+// MODBUS over Serial Line Specification and Implementation Guide V1.02
+// 2.2 - Unit IDs 248 to 255 are reserved
+#define UNIT_ID_QTY (248)
+
+// Values of sUnitIndex
+#define UNIT_NONE  (0)
+#define UNIT_MAIN  (1)
+#define UNIT_FIRST (2) // UNIT_FIRST + i is sUnits[i]
+
+// Device, Function, ByteCount, Data, CRC
+#if ((MODBUS_SLAVE_BUFFER_SIZE_byte - 5) / 2) < MODBUS_READ_REGISTERS_MAX
+    #define READ_REGISTERS_MAX ((MODBUS_SLAVE_BUFFER_SIZE_byte - 5) / 2)
+#else
+    #define READ_REGISTERS_MAX (MODBUS_READ_REGISTERS_MAX)
+#endif
+
+// Device, Function, Address, Count, ByteCount, Data, CRC
+#if ((MODBUS_SLAVE_BUFFER_SIZE_byte - 9) / 2) < MODBUS_WRITE_REGISTERS_MAX
+    #define WRITE_REGISTERS_MAX ((MODBUS_SLAVE_BUFFER_SIZE_byte - 9) / 2)
+#else
+    #define WRITE_REGISTERS_MAX (MODBUS_WRITE_REGISTERS_MAX)
+#endif
+
+// Device, Function, ByteCount, Data, CRC
+#if (16 * READ_REGISTERS_MAX) < MODBUS_READ_BITS_MAX
+    #define READ_BITS_MAX (16 * READ_REGISTERS_MAX)
+#else
+    #define READ_BITS_MAX (MODBUS_READ_BITS_MAX)
+#endif
+
+// Device, Function, Address, Count, ByteCount, Data, CRC
+#if (8 * (MODBUS_SLAVE_BUFFER_SIZE_byte - 9)) < MODBUS_WRITE_BITS_MAX
+    #define WRITE_BITS_MAX (8 * (MODBUS_SLAVE_BUFFER_SIZE_byte - 9))
+#else
+    #define WRITE_BITS_MAX (MODBUS_WRITE_BITS_MAX)
+#endif
+
+// Device, Function, ByteCount, FIFOCount, Data, CRC
+#if ((MODBUS_SLAVE_BUFFER_SIZE_byte - 8) / 2) < MODBUS_FIFO_COUNT_MAX
+    #define FIFO_COUNT_MAX ((MODBUS_SLAVE_BUFFER_SIZE_byte - 8) / 2)
+#else
+    #define FIFO_COUNT_MAX (MODBUS_FIFO_COUNT_MAX)
+#endif
+
+// Device, Function, ReadAddress, ReadCount, WriteAddress, WriteCount,
+// ByteCount, Data, CRC
+#if ((MODBUS_SLAVE_BUFFER_SIZE_byte - 13) / 2) < MODBUS_READ_WRITE_REGISTERS_MAX
+    #define READ_WRITE_REGISTERS_MAX ((MODBUS_SLAVE_BUFFER_SIZE_byte - 13) / 2)
+#else
+    #define READ_WRITE_REGISTERS_MAX (MODBUS_READ_WRITE_REGISTERS_MAX)
+#endif
 
 // Variables
 // //////////////////////////////////////////////////////////////////////////
 
-static uint8_t             sBuffer[32];
-static uint8_t             sCount;
-static uint16_t            sData[16];
-static uint8_t             sDevice;
-static uint8_t             sExpectedCount;
-static GPIO                sOutputEnable;
-static uint8_t             sRangeQty;
-static Modbus_Slave_Range* sRanges;
-static State               sState;
-static uint8_t             sUART;
+static uint8_t                   sBroken; // RTU - The frame is invalid
+static uint8_t                   sBuffer[MODBUS_SLAVE_BUFFER_SIZE_byte];
+static Modbus_Slave_Cache*       sCache;
+static uint8_t                   sCallDone;  // Callbacks completed for the request
+static uint8_t                   sCallIndex; // Callbacks reached in this pass
+static uint8_t                   sCallPending; // The callback following the completed ones returned MODBUS_SLAVE_PENDING
+static uint16_t                  sCount;
+static Modbus_Slave_Counters     sCounters;
+static uint16_t                  sData[READ_REGISTERS_MAX];
+static uint16_t                  sDataFirst; // Index in sData of the first register of the range operation
+static uint8_t                   sFast; // RTU - Modbus_Slave_InitFastRead was called
+static volatile uint8_t          sFastLock; // RTU_RxData must not process the request
+static uint8_t                   sNoResponse; // The master does not wait for the response
+static GPIO                      sOutputEnable; // RTU
+static uint16_t                  sOverrunBase; // RTU - UART_Overruns value at the last clear
+static uint16_t                  sPending_ms;
+static uint8_t                   sPendingException;
+static uint8_t                   sPendingResponse[1 + 1 + 1 + 2]; // Device, Function, Exception, CRC
+static uint16_t                  sPendingTimeout_ms;
+static const uint8_t*            sResponse; // Sealed response
+static const Modbus_Slave_Route* sRoute; // Route of the forwarded request
+static uint8_t                   sRouteQty;
+static const Modbus_Slave_Route* sRoutes;
+static uint16_t                  sRxCount;          // RTU
+static uint8_t*                  sRxFrame;          // RTU
+static uint16_t                  sRxFrameSize_byte; // RTU
+static uint8_t                   sRxKeep;           // RTU - RTU_TxComplete flushed the stream
+static uint16_t                  sRxNext;           // RTU - First entry of the next frame, or NO_ENTRY
+static uint8_t                   sRxStarted;        // RTU
+static uint8_t                   sSkipping;         // RTU
+static State                     sState;
+static uint16_t                  sStream[MODBUS_SLAVE_STREAM_SIZE]; // RTU
+static uint16_t                  sT15_us; // RTU
+static uint16_t                  sT35_us; // RTU
+static uint32_t                  sTime_ms; // Sum of the Modbus_Slave_Tick periods
+static Modbus_Slave_Transport    sTransport;
+static uint8_t                   sUART; // RTU
+static const Modbus_Slave_Unit*  sUnit; // Unit of the current request
+static uint8_t                   sUnitIndex[UNIT_ID_QTY];
+static Modbus_Slave_Unit         sUnitMain;
+static uint8_t                   sUnitQty;
+static const Modbus_Slave_Unit*  sUnits;
 
 // Static function declarations
 // //////////////////////////////////////////////////////////////////////////
 
+// aByte  Offset of the first byte of packed bits in sBuffer
+static void Bits_Get(uint16_t aByte, uint16_t aCount);
+
+// Return  Size of the answer excluding the CRC, in byte.
+static uint16_t Bits_Put(uint16_t aCount);
+
+// aSize_byte  Size of the sealed response in sBuffer
+static void Cache_Fill(uint16_t aSize_byte);
+
+// Return  0      The response is not in the cache
+//         Other  Size of the sealed cached response, in byte
+static uint16_t Cache_Use(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+
+// Return  MODBUS_NO_ERROR       Including when the callback was completed
+//                               before the request became pending
+//         MODBUS_EXCEPTION_...
+//         MODBUS_SLAVE_PENDING
+static uint8_t Call(Modbus_Slave_Callback aCallback, Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+
+// aByte  Offset of the first register value in sBuffer
+static void Data_Get(uint16_t aByte, uint16_t aCount);
+
+// Return  Size of the answer excluding the CRC, in byte.
+static uint16_t Data_Put(uint16_t aCount);
+
+static void Dirty_Set(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+
+// Return  0      aException is MODBUS_SLAVE_PENDING
+//         Other  Size of the exception answer excluding the CRC, in byte.
+static uint16_t Exception(uint8_t aException);
+
 // Return  Size of the answer excluding the CRC, in byte.
-static uint8_t Execute_READ_REGISTERS          (uint16_t aAddr, uint16_t aCount);
-static uint8_t Execute_WRITE_MULTIPLE_REGISTERS(uint16_t aAddr, uint16_t aCount);
-static uint8_t Execute_WRITE_SINGLE_REGISTER   (uint16_t aAddr, uint16_t aValue);
+static uint16_t Execute_MASK_WRITE_REGISTER          (uint16_t aAddr, uint16_t aAnd, uint16_t aOr);
+static uint16_t Execute_READ_BITS                    (Modbus_Slave_Range* aRanges, uint8_t aRangeQty, uint16_t aAddr, uint16_t aCount);
+static uint16_t Execute_READ_REGISTERS               (uint16_t aAddr, uint16_t aCount);
+static uint16_t Execute_READ_WRITE_MULTIPLE_REGISTERS(uint16_t aReadAddr, uint16_t aReadCount, uint16_t aWriteAddr, uint16_t aWriteCount);
+static uint16_t Execute_WRITE_MULTIPLE_COILS         (uint16_t aAddr, uint16_t aCount);
+static uint16_t Execute_WRITE_MULTIPLE_REGISTERS     (uint16_t aAddr, uint16_t aCount);
+static uint16_t Execute_WRITE_SINGLE_COIL            (uint16_t aAddr, uint16_t aValue);
+static uint16_t Execute_WRITE_SINGLE_REGISTER        (uint16_t aAddr, uint16_t aValue);
+
+// Return  NULL   No FIFO at this address
+static Modbus_Slave_FIFO* FindFIFO(uint16_t aAddr);
 
 // Return  NULL   No range find
 //         Other  The pointer to the range
-static Modbus_Slave_Range* FindRange(uint16_t aAddr, uint16_t aCount);
+static Modbus_Slave_Range* FindRange(Modbus_Slave_Range* aRanges, uint8_t aRangeQty, uint16_t aAddr, uint16_t aCount);
+
+// Return  NULL   The file or the records do not exist
+//         Other  The pointer to the record range
+static Modbus_Slave_Range* FindRecords(uint16_t aFile, uint16_t aRecord, uint16_t aCount);
+
+// Return  NULL   The unit ID is not part of any route
+static const Modbus_Slave_Route* FindRoute(uint8_t aDevice);
+
+// Return  NULL   The unit ID is not one of this slave
+static const Modbus_Slave_Unit* FindUnit(uint8_t aDevice);
+
+// Return  0      Pending
+//         Other  Size of the answer excluding the CRC, in byte
+static uint16_t Forward();
+
+// Return  0      The unit ID is neither one of this slave, nor part of a
+//                route, nor the broadcast address
+static uint8_t IsAddressed(uint8_t aDevice);
+
+// Return  0      The function is not allowed in a broadcast request
+static uint8_t IsBroadcastFunction();
+
+// Return  0      The request needs Modbus_Slave_Work
+static uint8_t IsFastRequest(const uint8_t* aFrame);
+
+// Return  Receive overruns since the last clear, 0 if the transport is not
+//         RTU
+static uint16_t Overruns();
 
 static void ParseRequest();
 
 // Return  Size of the answer excluding the CRC, in byte.
-static uint8_t Parse_READ_REGISTERS();
-static uint8_t Parse_WRITE_MULTIPLE_REGISTERS();
-static uint8_t Parse_WRITE_SINGLE_REGISTER();
+static uint16_t Parse_DIAGNOSTICS();
+static uint16_t Parse_MASK_WRITE_REGISTER();
+static uint16_t Parse_READ_COILS();
+static uint16_t Parse_READ_DISCRETE_INPUTS();
+static uint16_t Parse_READ_FIFO_QUEUE();
+static uint16_t Parse_READ_FILE_RECORD();
+static uint16_t Parse_READ_REGISTERS();
+static uint16_t Parse_READ_WRITE_MULTIPLE_REGISTERS();
+static uint16_t Parse_WRITE_FILE_RECORD();
+static uint16_t Parse_WRITE_MULTIPLE_COILS();
+static uint16_t Parse_WRITE_MULTIPLE_REGISTERS();
+static uint16_t Parse_WRITE_SINGLE_COIL();
+static uint16_t Parse_WRITE_SINGLE_REGISTER();
+
+// Execute the request in sBuffer. Called again while it is pending.
+static void ProcessRequest();
+
+// Return  0      Unknown function
+//         Other  Expected size of the request excluding the CRC, in byte
+static uint16_t RequestSize();
+
+static uint8_t Range_Read     (Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+static uint8_t Range_ReadBits (Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+static uint8_t Range_Write    (Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+static uint8_t Range_WriteBits(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount);
+
+// When a pending request is executed again, the operations preceding the
+// completed callbacks must not modify sData again.
+// Return  false  Execute the operation
+//         true   Skip the operation
+static uint8_t Replaying();
+
+// When a pending request is executed again, the pending callback must
+// find the data it left in sData.
+// Return  false  Prepare sData and call the callback
+//         true   Call the callback again without touching sData
+static uint8_t Retrying();
+
+// Return  Size of the sealed frame, in byte
+static uint16_t Seal(uint8_t* aFrame, uint16_t aSize_byte);
+
+static void Set_PENDING_Expired();
+static void Set_SENDING(uint16_t aSize_byte);
+
+// aResult  The result of the last callback of the operation, not replayed
+//
+// Return  aResult
+static uint8_t Stats_Update(Modbus_Slave_Range* aRange, uint8_t aWrite, uint16_t aCount, uint8_t aResult);
+
+static void Work_PENDING  ();
+static void Work_RECEIVING();
+static void Work_SENDING  ();
 
-static void Set_WAITING();
-static void Set_WRITING(uint8_t aSize_byte);
+// ===== RTU transport ======================================================
 
-static void Work_READING();
-static void Work_WAITING();
-static void Work_WRITING();
+// aContext  Not used
+static uint16_t RTU_Receive(void* aContext, uint8_t* aFrame, uint16_t aFrameSize_byte);
+static uint16_t RTU_Seal   (void* aContext, uint8_t* aFrame, uint16_t aSize_byte);
+static void     RTU_Send   (void* aContext, const uint8_t* aFrame, uint16_t aSize_byte);
+static uint8_t  RTU_Sent   (void* aContext);
+static void     RTU_Tick   (void* aContext, uint16_t aPeriod_ms);
+
+// The UART stores the received bytes in sStream. Only one context reads it
+// at a time: Work_RECEIVING, or RTU_RxData while Work_RECEIVING does not
+// have the lock, in STATE_RECEIVING, RTU_TxComplete in STATE_SENDING and
+// RTU_Tick in the other states.
+
+// Move the received bytes of the current frame to sRxFrame
+//
+// Return  false  The frame may continue
+//         true   The next frame started, its first entry is in sRxNext
+static uint8_t RTU_Collect();
+
+// Process the request if IsFastRequest accepts it. Interrupt context, or
+// Work_RECEIVING
+static void RTU_Fast();
+
+// Drop the received bytes
+static void RTU_Flush();
+
+// Start receiving the next frame
+static void RTU_Start(uint8_t* aFrame, uint16_t aFrameSize_byte);
+
+static void RTU_Store(uint16_t aEntry);
+
+// Interrupt context
+static void RTU_RxData    (void* aContext);
+static void RTU_TxComplete(void* aContext);
+
+static const Modbus_Slave_Transport RTU_TRANSPORT = { NULL, RTU_Receive, RTU_Seal, RTU_Send, RTU_Sent, RTU_Tick };
 
 // Functions
 // //////////////////////////////////////////////////////////////////////////
 
 void Modbus_Slave_Init(uint8_t aUART, uint8_t aDevice, Modbus_Slave_Range* aRanges, uint8_t aRangeQty, GPIO aOutputEnable)
 {
-    // assert(0 < aDevice);
-    // assert(NULL != aRanges);
-    // assert(0 < aRangeQty);
-
-    sDevice       = aDevice;
     sOutputEnable = aOutputEnable;
-    sRanges       = aRanges;
-    sRangeQty     = aRangeQty;
-    sState        = STATE_INIT;
+    sOverrunBase  = 0;
+    sRxKeep       = 0;
+    sRxNext       = NO_ENTRY;
+    sRxStarted    = 0;
+    sT15_us       = 0; // RTU_Start starts the stream
     sUART         = aUART;
 
     sOutputEnable.mOutput        = 1;
     sOutputEnable.mSlewRate_Slow = 1;
 
     UART_Init(sUART);
+    UART_SetTxComplete(sUART, RTU_TxComplete, NULL);
 
     GPIO_Output(sOutputEnable, 0);
+
+    Modbus_Slave_InitTransport(&RTU_TRANSPORT, aDevice, aRanges, aRangeQty);
 }
 
-uint8_t Modbus_Slave_Callback_Default(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+void Modbus_Slave_InitTransport(const Modbus_Slave_Transport* aTransport, uint8_t aDevice, Modbus_Slave_Range* aRanges, uint8_t aRangeQty)
 {
-    // assert(NULL != aRange);
-    // assert(0 < aCount);
-    // assert(NULL != aData);
+    // assert(NULL != aTransport);
+    // assert(0 < aDevice);
+    // assert(UNIT_ID_QTY > aDevice);
+    // assert(NULL != aRanges);
+    // assert(0 < aRangeQty);
 
-    return MODBUS_NO_ERROR;
+    sRoutes    = NULL;
+    sRouteQty  = 0;
+    sFast      = 0;
+    sState     = STATE_INIT;
+    sTransport = *aTransport;
+    sUnitQty   = 0;
+    sUnits     = NULL;
+
+    sUnitMain.mCoils    = NULL;
+    sUnitMain.mCoilQty  = 0;
+    sUnitMain.mDevice   = aDevice;
+    sUnitMain.mFIFOs    = NULL;
+    sUnitMain.mFIFOQty  = 0;
+    sUnitMain.mFiles    = NULL;
+    sUnitMain.mFileQty  = 0;
+    sUnitMain.mInputs   = NULL;
+    sUnitMain.mInputQty = 0;
+    sUnitMain.mRanges   = aRanges;
+    sUnitMain.mRangeQty = aRangeQty;
+
+    memset(sUnitIndex, UNIT_NONE, sizeof(sUnitIndex));
+
+    sUnitIndex[aDevice] = UNIT_MAIN;
+
+    memset(&sCounters, 0, sizeof(sCounters));
+
+    sPendingException  = MODBUS_EXCEPTION_SERVER_DEVICE_BUSY;
+    sPendingTimeout_ms = DEFAULT_PENDING_TIMEOUT_ms;
 }
 
-uint8_t Modbus_Slave_Callback_Error(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+void Modbus_Slave_InitBits(Modbus_Slave_Range* aCoils, uint8_t aCoilQty, Modbus_Slave_Range* aInputs, uint8_t aInputQty)
 {
-    // assert(NULL != aRange);
-    // assert(0 < aCount);
-    // assert(NULL != aData);
+    // assert((NULL != aCoils) || (0 == aCoilQty));
+    // assert((NULL != aInputs) || (0 == aInputQty));
 
-    return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+    sUnitMain.mCoils    = aCoils;
+    sUnitMain.mCoilQty  = aCoilQty;
+    sUnitMain.mInputs   = aInputs;
+    sUnitMain.mInputQty = aInputQty;
 }
 
-void Modbus_Slave_Tick(uint16_t aPeriod_ms)
+void Modbus_Slave_InitFIFOs(Modbus_Slave_FIFO* aFIFOs, uint8_t aFIFOQty)
 {
-    // assert(0 < aPeriod_ms);
+    // assert((NULL != aFIFOs) || (0 == aFIFOQty));
 
-    switch (sState)
-    {
-    case STATE_ERROR: sState = STATE_INIT; break;
+    sUnitMain.mFIFOs   = aFIFOs;
+    sUnitMain.mFIFOQty = aFIFOQty;
+}
 
-    case STATE_INIT: Set_WAITING(); break;
+void Modbus_Slave_InitFastRead()
+{
+    // assert(RTU_Receive == sTransport.mReceive);
 
-    case STATE_READING:
-    case STATE_WAITING:
-        UART_Tick(sUART, UART_READ, aPeriod_ms);
-        break;
+    sFast = 1;
 
-    case STATE_WRITING:
-        UART_Tick(sUART, UART_WRITE, aPeriod_ms);
-        break;
+    UART_SetRxData(sUART, RTU_RxData, NULL);
+}
 
-    // default: assert(false);
-    }
+void Modbus_Slave_InitFiles(const Modbus_Slave_File* aFiles, uint8_t aFileQty)
+{
+    // assert((NULL != aFiles) || (0 == aFileQty));
+
+    sUnitMain.mFiles   = aFiles;
+    sUnitMain.mFileQty = aFileQty;
 }
 
-void Modbus_Slave_Work()
+void Modbus_Slave_InitGateway(const Modbus_Slave_Route* aRoutes, uint8_t aRouteQty)
 {
-    switch (sState)
-    {
-    case STATE_ERROR:
-    case STATE_INIT: break;
+    // assert((NULL != aRoutes) || (0 == aRouteQty));
 
-    case STATE_READING: Work_READING(); break;
-    case STATE_WAITING: Work_WAITING(); break;
-    case STATE_WRITING: Work_WRITING(); break;
+    sRoutes   = aRoutes;
+    sRouteQty = aRouteQty;
+}
 
-    // default: assert(false);
+void Modbus_Slave_InitUnits(const Modbus_Slave_Unit* aUnits, uint8_t aUnitQty)
+{
+    // assert((NULL != aUnits) || (0 == aUnitQty));
+    // assert((0xff - UNIT_FIRST) >= aUnitQty);
+
+    uint8_t i;
+
+    sUnits   = aUnits;
+    sUnitQty = aUnitQty;
+
+    for (i = 0; i < aUnitQty; i++)
+    {
+        // assert(0 < aUnits[i].mDevice);
+        // assert(UNIT_ID_QTY > aUnits[i].mDevice);
+
+        sUnitIndex[aUnits[i].mDevice] = UNIT_FIRST + i;
     }
 }
 
-// Static functions
-// //////////////////////////////////////////////////////////////////////////
-
-uint8_t Execute_READ_REGISTERS(uint16_t aAddr, uint16_t aCount)
+void Modbus_Slave_InitPending(uint16_t aTimeout_ms, uint8_t aException)
 {
-    // assert(0 < aCount);
+    // assert((MODBUS_EXCEPTION_ACKNOWLEDGE == aException) || (MODBUS_EXCEPTION_SERVER_DEVICE_BUSY == aException));
 
-    uint8_t lResult_byte = 1 + 1 + 1; // Device, Function, Exception
+    sPendingException  = aException;
+    sPendingTimeout_ms = aTimeout_ms;
+}
 
-    Modbus_Slave_Range* lRange = FindRange(aAddr, aCount);
-    if (NULL != lRange)
-    {
-        uint8_t lRet;
+uint8_t Modbus_Slave_Callback_Default(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+    // assert(NULL != aData);
 
-        unsigned int i;
+    return MODBUS_NO_ERROR;
+}
 
-        if (NULL == lRange->mData)
-        {
-            for (i = 0; i < aCount; i++)
-            {
-                sData[i] = 0;
-            }
-        }
-        else
-        {
-            uint16_t lIndex = aAddr - lRange->mAddress;
+uint8_t Modbus_Slave_Callback_Error(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+    // assert(NULL != aData);
 
-            for (i = 0; i < aCount; i++)
-            {
-                sData[i] = lRange->mData[lIndex + i];
-            }
-        }
+    return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+}
 
-        lRet = lRange->mAfterRead(lRange, aAddr, aCount, sData);
-        if (MODBUS_NO_ERROR == lRet)
-        {
-            lResult_byte = 1 + 1; // Device, Function
+uint8_t Modbus_Slave_Callback_GPIO_Input(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+    // assert(NULL != aData);
 
-            // TODO  Validate aCount value
+    const Modbus_Slave_GPIO* lGPIO  = (const Modbus_Slave_GPIO*)aRange->mContext;
+    uint16_t                 lIndex = aAddress - aRange->mAddress;
 
-            sBuffer[lResult_byte] = sizeof(uint16_t) * (uint8_t)aCount;
-            lResult_byte++;
+    unsigned int i;
 
-            for (i = 0; i < aCount; i++)
-            {
-                uint8_t lHigh = (uint8_t)(sData[i] >> 8);
-                uint8_t lLow  = (uint8_t) sData[i];
+    // assert(NULL != lGPIO);
+    // assert(NULL != lGPIO->mInput);
 
-                sBuffer[lResult_byte    ] = lHigh;
-                sBuffer[lResult_byte + 1] = lLow;
+    for (i = 0; i < aCount; i++)
+    {
+        uint16_t lMask = 1 << (i % 16);
 
-                lResult_byte += sizeof(uint16_t);
-            }
+        if (lGPIO->mInput(lGPIO->mGPIOs[lIndex + i]))
+        {
+            aData[i / 16] |= lMask;
         }
         else
         {
-            sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-            sBuffer[MODBUS_BYTE_EXCEPTION]  = lRet;
+            aData[i / 16] &= ~ lMask;
         }
     }
-    else
-    {
-        sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-        sBuffer[MODBUS_BYTE_EXCEPTION]  = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
-    }
 
-    return lResult_byte;
+    return MODBUS_NO_ERROR;
 }
 
-uint8_t Execute_WRITE_MULTIPLE_REGISTERS(uint16_t aAddr, uint16_t aCount)
+uint8_t Modbus_Slave_Callback_GPIO_Output(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
 {
+    // assert(NULL != aRange);
     // assert(0 < aCount);
+    // assert(NULL != aData);
 
-    uint8_t lResult_byte = 1 + 1 + 1; // Device, Function, Exception
-
-    Modbus_Slave_Range* lRange = FindRange(aAddr, aCount);
-    if (NULL != lRange)
-    {
-        uint8_t  lByte  = 7;
-        uint16_t lIndex = aAddr - lRange->mAddress;
-        uint8_t  lRet   = 0;
-
-        uint8_t i;
-
-        for (i = 0; i < aCount; i++)
-        {
-            sData[i] = sBuffer[lByte];
-            sData[i] <<= 8;
-            sData[i] |= sBuffer[lByte + 1];
-
-            lByte += sizeof(uint16_t);
-        }
+    const Modbus_Slave_GPIO* lGPIO  = (const Modbus_Slave_GPIO*)aRange->mContext;
+    uint16_t                 lIndex = aAddress - aRange->mAddress;
 
-        lRet = lRange->mBeforeWrite(lRange, aAddr, aCount, sData);
-        if (MODBUS_NO_ERROR == lRet)
-        {
-            if (NULL != lRange->mData)
-            {
-                for (i = 0; i < aCount; i++)
-                {
-                    lRange->mData[lIndex + i] = sData[i];
-                }
-            }
+    unsigned int i;
 
-            lRet = lRange->mAfterWrite(lRange, aAddr, aCount, sData);
-            if (0 == lRet)
-            {
-                lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Count
-            }
-        }
+    // assert(NULL != lGPIO);
+    // assert(NULL != lGPIO->mOutput);
 
-        if (MODBUS_NO_ERROR != lRet)
-        {
-            sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-            sBuffer[MODBUS_BYTE_EXCEPTION]  = lRet;
-        }
-    }
-    else
+    for (i = 0; i < aCount; i++)
     {
-        sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-        sBuffer[MODBUS_BYTE_EXCEPTION]  = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+        lGPIO->mOutput(lGPIO->mGPIOs[lIndex + i], 0 != (aData[i / 16] & (1 << (i % 16))));
     }
 
-    return lResult_byte;
+    return MODBUS_NO_ERROR;
 }
 
-uint8_t Execute_WRITE_SINGLE_REGISTER(uint16_t aAddr, uint16_t aValue)
+void Modbus_Slave_Commit(Modbus_Slave_Range* aRange)
 {
-    uint8_t lResult_byte = 1 + 1 + 1; // Device, Function, Exception
+    // assert(NULL != aRange);
+    // assert(NULL != aRange->mBack);
 
-    Modbus_Slave_Range* lRange = FindRange(aAddr, 1);
-    if (NULL != lRange)
-    {
-        uint16_t lIndex = aAddr - lRange->mAddress;
-        uint8_t  lRet;
+    uint16_t* lData = aRange->mBack;
 
-        sData[0] = aValue;
+    aRange->mBack = aRange->mData;
+    aRange->mData = lData;
 
-        lRet = lRange->mBeforeWrite(lRange, aAddr, 1, sData);
-        if (MODBUS_NO_ERROR == lRet)
-        {
-            if (NULL != lRange->mData)
-            {
-                lRange->mData[lIndex] = sData[0];
-            }
+    aRange->mCommits++;
 
-            lRet = lRange->mAfterWrite(lRange, aAddr, 1, sData);
-            if (0 == lRet)
-            {
-                uint8_t lHigh = (uint8_t)(sData[0] >> 8);
-                uint8_t lLow  = (uint8_t) sData[0];
+    Modbus_Slave_Publish(aRange);
+}
 
-                sBuffer[4] = lHigh;
-                sBuffer[5] = lHigh;
+uint8_t Modbus_Slave_FIFO_Push(Modbus_Slave_FIFO* aFIFO, uint16_t aValue)
+{
+    // assert(NULL != aFIFO);
+    // assert(1 < aFIFO->mSize);
 
-                lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Value
-            }
-        }
+    uint16_t lIn   = aFIFO->mIn;
+    uint16_t lNext = lIn + 1;
 
-        if (MODBUS_NO_ERROR != lRet)
-        {
-            sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-            sBuffer[MODBUS_BYTE_EXCEPTION]  = lRet;
-        }
+    if (aFIFO->mSize <= lNext)
+    {
+        lNext = 0;
     }
-    else
+
+    if (aFIFO->mOut == lNext)
     {
-        sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-        sBuffer[MODBUS_BYTE_EXCEPTION]  = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+        aFIFO->mOverflows++;
+        return 0;
     }
 
-    return lResult_byte;
+    // The value is stored before it becomes visible to Modbus_Slave
+    aFIFO->mData[lIn] = aValue;
+    aFIFO->mIn        = lNext;
+
+    return 1;
 }
 
-Modbus_Slave_Range* FindRange(uint16_t aAddr, uint16_t aCount)
+void Modbus_Slave_GetCounters(Modbus_Slave_Counters* aOut)
 {
-    // assert(0 < aCount);
+    // assert(NULL != aOut);
 
-    uint16_t lEnd = aAddr + aCount;
+    *aOut = sCounters;
 
-    uint8_t i;
+    aOut->mOverruns = Overruns();
+}
 
-    for (i = 0; i < sRangeQty; i++)
-    {
-        uint16_t lRA = sRanges[i].mAddress;
+void Modbus_Slave_GetStats(const Modbus_Slave_Range* aRange, Modbus_Slave_Stats* aOut)
+{
+    // assert(NULL != aRange);
+    // assert(NULL != aRange->mStats);
+    // assert(NULL != aOut);
 
-        if ((lRA <= aAddr) && ((lRA + sRanges[i].mCount) >= lEnd))
-        {
-            return sRanges + i;
-        }
-    }
+    *aOut = *aRange->mStats;
 
-    return NULL;
+    aOut->mAccess_ms = sTime_ms - aOut->mAccess_ms;
 }
 
-void ParseRequest()
+uint8_t Modbus_Slave_NextDirty(Modbus_Slave_Range* aRange, uint16_t* aAddress)
 {
-    if (UNKNOWN_EXPECTED_COUNT == sExpectedCount)
+    // assert(NULL != aRange);
+    // assert(NULL != aRange->mDirty);
+    // assert(NULL != aAddress);
+
+    Modbus_Slave_Dirty* lDirty = aRange->mDirty;
+
+    while (lDirty->mFirst < lDirty->mEnd)
     {
-        if (MODBUS_BYTE_FUNCTION < sCount)
+        uint16_t  lIndex = lDirty->mFirst;
+        uint16_t* lWord  = lDirty->mBits + lIndex / 16;
+        uint16_t  lMask  = 1 << (lIndex % 16);
+
+        if (0 == *lWord)
         {
-            switch (sBuffer[MODBUS_BYTE_FUNCTION])
-            {
-            case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
-            case MODBUS_FUNCTION_READ_INPUT_REGISTERS  :
-                sExpectedCount = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Count, CRC
-                break;
-
-            case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER:
-                sExpectedCount = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Value, CRC
-                break;
-            }
+            // Skip the rest of the word
+            lDirty->mFirst = (lIndex | 15) + 1;
         }
-        if (6 < sCount)
+        else
         {
-            switch (sBuffer[MODBUS_BYTE_FUNCTION])
+            lDirty->mFirst++;
+
+            if (0 != (*lWord & lMask))
             {
-            case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS:
-                sExpectedCount  = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t) + 1; // Device, Function, Address, Count, Size_byte
-                sExpectedCount += sBuffer[6];
-                sExpectedCount += 2; // CRC
-                break;
-
-            default:
-                UART_Abort(sUART, UART_READ);
-                sState = STATE_ERROR;
+                *lWord &= ~ lMask;
+
+                *aAddress = aRange->mAddress + lIndex;
+                return 1;
             }
         }
     }
 
-    if (sExpectedCount <= sCount)
-    {
-        UART_Abort(sUART, UART_READ);
+    return 0;
+}
 
-        if (Modbus_CRC_Verify_Buffer(sBuffer, sCount) && (sDevice == sBuffer[MODBUS_BYTE_DEVICE]))
-        {
-            uint8_t lSize_byte = 1 + 1 + 1; // Device, Function, Exception
+void Modbus_Slave_Publish(Modbus_Slave_Range* aRange)
+{
+    // assert(NULL != aRange);
 
-            switch (sBuffer[MODBUS_BYTE_FUNCTION])
-            {
-            case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
-            case MODBUS_FUNCTION_READ_INPUT_REGISTERS  : lSize_byte = Parse_READ_REGISTERS(); break;
+    Modbus_Slave_Cache* lCache = aRange->mCache;
 
-            case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS: lSize_byte = Parse_WRITE_MULTIPLE_REGISTERS(); break;
-            case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER   : lSize_byte = Parse_WRITE_SINGLE_REGISTER   (); break;
+    if (NULL != lCache)
+    {
+        lCache->mFilling   = 0;
+        lCache->mSize_byte = 0;
+    }
+}
 
-            default:
-                sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
-                sBuffer[MODBUS_BYTE_EXCEPTION]  = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
-            }
+void Modbus_Slave_Tick(uint16_t aPeriod_ms)
+{
+    // assert(0 < aPeriod_ms);
 
-            Modbus_CRC_Compute_Buffer(sBuffer, lSize_byte);
+    sTime_ms += aPeriod_ms;
 
-            lSize_byte += sizeof(uint16_t); // CRC
+    if (NULL != sTransport.mTick)
+    {
+        sTransport.mTick(sTransport.mContext, aPeriod_ms);
+    }
 
-            Set_WRITING(lSize_byte);
-        }
-        else
+    switch (sState)
+    {
+    case STATE_ERROR: sState = STATE_INIT; break;
+
+    case STATE_INIT:
+        // Start the reception without waiting for Modbus_Slave_Work
+        sState = STATE_RECEIVING;
+        Work_RECEIVING();
+        break;
+
+    case STATE_PENDING:
+        // The forward function reports the downstream timeout
+        if ((!sNoResponse) && (NULL == sRoute))
         {
-            Set_WAITING();
+            sPending_ms += aPeriod_ms;
+            if (sPendingTimeout_ms <= sPending_ms)
+            {
+                Set_PENDING_Expired();
+            }
         }
+        break;
+
+    case STATE_RECEIVING:
+    case STATE_SENDING  : break;
+
+    // default: assert(false);
     }
 }
 
-// Device 0x03 AddrH AddrL CountH CountL
-// Device 0x04 AddrH AddrL CountH CountL
-uint8_t Parse_READ_REGISTERS()
+void Modbus_Slave_Work()
 {
-    uint16_t lAddr  = sBuffer[2];
-    uint16_t lCount = sBuffer[4];
-
-    lAddr  <<= 8;
-    lAddr |= sBuffer[3];
+    switch (sState)
+    {
+    case STATE_ERROR:
+    case STATE_INIT: break;
 
-    lCount <<= 8;
-    lCount |= sBuffer[5];
+    case STATE_PENDING  : Work_PENDING  (); break;
+    case STATE_RECEIVING: Work_RECEIVING(); break;
+    case STATE_SENDING  : Work_SENDING  (); break;
 
-    return Execute_READ_REGISTERS(lAddr, lCount);
+    // default: assert(false);
+    }
 }
 
-// Device 0x10 AddrH AddrL CountH CountL ByteCount ...
-uint8_t Parse_WRITE_MULTIPLE_REGISTERS()
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Bits_Get(uint16_t aByte, uint16_t aCount)
 {
-    uint16_t lAddr  = sBuffer[2];
-    uint16_t lCount = sBuffer[4];
+    uint16_t lSize_byte = (aCount + 7) / 8;
 
-    lAddr <<= 8;
-    lAddr |= sBuffer[3];
+    unsigned int i;
 
-    lCount <<= 8;
-    lCount |= sBuffer[5];
+    if (Replaying())
+    {
+        return;
+    }
 
-    return Execute_WRITE_MULTIPLE_REGISTERS(lAddr, lCount);
+    for (i = 0; i < lSize_byte; i++)
+    {
+        uint16_t lByte = sBuffer[aByte + i];
+
+        if (0 == (i % 2))
+        {
+            sData[i / 2] = lByte;
+        }
+        else
+        {
+            sData[i / 2] |= lByte << 8;
+        }
+    }
+
+    if (0 != (aCount % 16))
+    {
+        sData[aCount / 16] &= (1 << (aCount % 16)) - 1;
+    }
+}
+
+// Device Function ByteCount ...
+uint16_t Bits_Put(uint16_t aCount)
+{
+    uint16_t lResult_byte = 1 + 1; // Device, Function
+    uint16_t lSize_byte   = (aCount + 7) / 8;
+
+    unsigned int i;
+
+    if (0 != (aCount % 16))
+    {
+        sData[aCount / 16] &= (1 << (aCount % 16)) - 1;
+    }
+
+    sBuffer[lResult_byte] = (uint8_t)lSize_byte;
+    lResult_byte++;
+
+    for (i = 0; i < lSize_byte; i++)
+    {
+        uint16_t lWord = sData[i / 2];
+
+        if (0 != (i % 2))
+        {
+            lWord >>= 8;
+        }
+
+        sBuffer[lResult_byte] = (uint8_t)lWord;
+        lResult_byte++;
+    }
+
+    return lResult_byte;
+}
+
+void Cache_Fill(uint16_t aSize_byte)
+{
+    // assert(NULL != sCache);
+
+    if ((sCache->mFilling) && (sCache->mFrameSize_byte >= aSize_byte) && (0 == (sBuffer[MODBUS_BYTE_FUNCTION] & MODBUS_FUNCTION_ERROR)))
+    {
+        memcpy(sCache->mFrame, sBuffer, aSize_byte);
+
+        sCache->mSize_byte = aSize_byte;
+    }
+
+    sCache->mFilling = 0;
+}
+
+uint16_t Cache_Use(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(NULL != aRange);
+
+    Modbus_Slave_Cache* lCache = aRange->mCache;
+
+    if (NULL != lCache)
+    {
+        uint8_t lDevice   = sBuffer[MODBUS_BYTE_DEVICE  ];
+        uint8_t lFunction = sBuffer[MODBUS_BYTE_FUNCTION];
+
+        // Units may share ranges. The cached response contains the unit ID.
+        if ((0 < lCache->mSize_byte) && (lDevice == lCache->mDevice) && (lFunction == lCache->mFunction)
+            && (aAddr == lCache->mAddress) && (aCount == lCache->mCount))
+        {
+            sResponse = lCache->mFrame;
+
+            Stats_Update(aRange, 0, aCount, MODBUS_NO_ERROR);
+
+            return lCache->mSize_byte;
+        }
+
+        // Modbus_Slave_Publish clears mFilling if the data change before
+        // the response is completed.
+        lCache->mAddress   = aAddr;
+        lCache->mCount     = aCount;
+        lCache->mDevice    = lDevice;
+        lCache->mFunction  = lFunction;
+        lCache->mSize_byte = 0;
+        lCache->mFilling   = 1;
+
+        sCache = lCache;
+    }
+
+    return 0;
+}
+
+uint8_t Call(Modbus_Slave_Callback aCallback, Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(NULL != aCallback);
+
+    uint8_t lResult;
+
+    if (Replaying())
+    {
+        sCallIndex++;
+        return MODBUS_NO_ERROR;
+    }
+
+    lResult = aCallback(aRange, aAddr, aCount, sData + sDataFirst);
+
+    sCallPending = (MODBUS_SLAVE_PENDING == lResult);
+    if (!sCallPending)
+    {
+        sCallDone++;
+    }
+
+    sCallIndex++;
+
+    return lResult;
+}
+
+void Data_Get(uint16_t aByte, uint16_t aCount)
+{
+    uint16_t lByte = aByte;
+
+    unsigned int i;
+
+    if (Replaying())
+    {
+        return;
+    }
+
+    for (i = 0; i < aCount; i++)
+    {
+        sData[i] = sBuffer[lByte];
+        sData[i] <<= 8;
+        sData[i] |= sBuffer[lByte + 1];
+
+        lByte += sizeof(uint16_t);
+    }
+}
+
+// Device Function ByteCount ...
+uint16_t Data_Put(uint16_t aCount)
+{
+    uint16_t lResult_byte = 1 + 1; // Device, Function
+
+    unsigned int i;
+
+    sBuffer[lResult_byte] = (uint8_t)(sizeof(uint16_t) * aCount);
+    lResult_byte++;
+
+    for (i = 0; i < aCount; i++)
+    {
+        uint8_t lHigh = (uint8_t)(sData[i] >> 8);
+        uint8_t lLow  = (uint8_t) sData[i];
+
+        sBuffer[lResult_byte    ] = lHigh;
+        sBuffer[lResult_byte + 1] = lLow;
+
+        lResult_byte += sizeof(uint16_t);
+    }
+
+    return lResult_byte;
+}
+
+void Dirty_Set(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+
+    Modbus_Slave_Dirty* lDirty = aRange->mDirty;
+
+    if (NULL != lDirty)
+    {
+        uint16_t lIndex = aAddr - aRange->mAddress;
+        uint16_t lEnd   = lIndex + aCount;
+
+        uint16_t i;
+
+        for (i = lIndex; i < lEnd; i++)
+        {
+            lDirty->mBits[i / 16] |= 1 << (i % 16);
+        }
+
+        if (lDirty->mFirst >= lDirty->mEnd)
+        {
+            lDirty->mFirst = lIndex;
+            lDirty->mEnd   = lEnd;
+        }
+        else
+        {
+            if (lDirty->mFirst > lIndex) { lDirty->mFirst = lIndex; }
+            if (lDirty->mEnd   < lEnd  ) { lDirty->mEnd   = lEnd  ; }
+        }
+    }
+}
+
+uint16_t Exception(uint8_t aException)
+{
+    // assert(MODBUS_NO_ERROR != aException);
+
+    if (MODBUS_SLAVE_PENDING == aException)
+    {
+        return 0;
+    }
+
+    sBuffer[MODBUS_BYTE_FUNCTION ] |= MODBUS_FUNCTION_ERROR;
+    sBuffer[MODBUS_BYTE_EXCEPTION]  = aException;
+
+    sCounters.mBusExceptions++;
+
+    return 1 + 1 + 1; // Device, Function, Exception
+}
+
+uint16_t Execute_MASK_WRITE_REGISTER(uint16_t aAddr, uint16_t aAnd, uint16_t aOr)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+
+    lRange = FindRange(sUnit->mRanges, sUnit->mRangeQty, aAddr, 1);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    lRet = Range_Read(lRange, aAddr, 1);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    if (!Replaying())
+    {
+        sData[0] = (sData[0] & aAnd) | (aOr & (~ aAnd));
+    }
+
+    lRet = Range_Write(lRange, aAddr, 1);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return 1 + 1 + 3 * sizeof(uint16_t); // Device, Function, Address, And, Or
+}
+
+uint16_t Execute_READ_BITS(Modbus_Slave_Range* aRanges, uint8_t aRangeQty, uint16_t aAddr, uint16_t aCount)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+    uint16_t            lSize_byte;
+
+    if ((0 == aCount) || (READ_BITS_MAX < aCount))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lRange = FindRange(aRanges, aRangeQty, aAddr, aCount);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    lSize_byte = Cache_Use(lRange, aAddr, aCount);
+    if (0 < lSize_byte)
+    {
+        return lSize_byte;
+    }
+
+    lRet = Range_ReadBits(lRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return Bits_Put(aCount);
+}
+
+uint16_t Execute_READ_REGISTERS(uint16_t aAddr, uint16_t aCount)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+    uint16_t            lSize_byte;
+
+    if ((0 == aCount) || (READ_REGISTERS_MAX < aCount))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lRange = FindRange(sUnit->mRanges, sUnit->mRangeQty, aAddr, aCount);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    lSize_byte = Cache_Use(lRange, aAddr, aCount);
+    if (0 < lSize_byte)
+    {
+        return lSize_byte;
+    }
+
+    lRet = Range_Read(lRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return Data_Put(aCount);
+}
+
+uint16_t Execute_READ_WRITE_MULTIPLE_REGISTERS(uint16_t aReadAddr, uint16_t aReadCount, uint16_t aWriteAddr, uint16_t aWriteCount)
+{
+    Modbus_Slave_Range* lReadRange;
+    uint8_t             lRet;
+    Modbus_Slave_Range* lWriteRange;
+
+    if ((0 == aReadCount) || (READ_REGISTERS_MAX < aReadCount)
+        || (0 == aWriteCount) || (READ_WRITE_REGISTERS_MAX < aWriteCount) || (sizeof(uint16_t) * aWriteCount != sBuffer[10]))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lReadRange  = FindRange(sUnit->mRanges, sUnit->mRangeQty, aReadAddr , aReadCount );
+    lWriteRange = FindRange(sUnit->mRanges, sUnit->mRangeQty, aWriteAddr, aWriteCount);
+    if ((NULL == lReadRange) || (NULL == lWriteRange))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    // The write operation is performed before the read operation.
+    Data_Get(11, aWriteCount);
+
+    lRet = Range_Write(lWriteRange, aWriteAddr, aWriteCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    lRet = Range_Read(lReadRange, aReadAddr, aReadCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return Data_Put(aReadCount);
+}
+
+uint16_t Execute_WRITE_MULTIPLE_COILS(uint16_t aAddr, uint16_t aCount)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+
+    if ((0 == aCount) || (WRITE_BITS_MAX < aCount) || ((aCount + 7) / 8 != sBuffer[6]))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lRange = FindRange(sUnit->mCoils, sUnit->mCoilQty, aAddr, aCount);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    Bits_Get(7, aCount);
+
+    lRet = Range_WriteBits(lRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Count
+}
+
+uint16_t Execute_WRITE_MULTIPLE_REGISTERS(uint16_t aAddr, uint16_t aCount)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+
+    if ((0 == aCount) || (WRITE_REGISTERS_MAX < aCount) || (sizeof(uint16_t) * aCount != sBuffer[6]))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lRange = FindRange(sUnit->mRanges, sUnit->mRangeQty, aAddr, aCount);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    Data_Get(7, aCount);
+
+    lRet = Range_Write(lRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Count
+}
+
+uint16_t Execute_WRITE_SINGLE_COIL(uint16_t aAddr, uint16_t aValue)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+
+    if ((MODBUS_COIL_OFF != aValue) && (MODBUS_COIL_ON != aValue))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    lRange = FindRange(sUnit->mCoils, sUnit->mCoilQty, aAddr, 1);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    if (!Replaying())
+    {
+        sData[0] = (MODBUS_COIL_ON == aValue) ? 1 : 0;
+    }
+
+    lRet = Range_WriteBits(lRange, aAddr, 1);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Value
+}
+
+uint16_t Execute_WRITE_SINGLE_REGISTER(uint16_t aAddr, uint16_t aValue)
+{
+    Modbus_Slave_Range* lRange;
+    uint8_t             lRet;
+
+    lRange = FindRange(sUnit->mRanges, sUnit->mRangeQty, aAddr, 1);
+    if (NULL == lRange)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    if (!Replaying())
+    {
+        sData[0] = aValue;
+    }
+
+    lRet = Range_Write(lRange, aAddr, 1);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        return Exception(lRet);
+    }
+
+    sBuffer[4] = (uint8_t)(sData[0] >> 8);
+    sBuffer[5] = (uint8_t) sData[0];
+
+    return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Value
+}
+
+Modbus_Slave_FIFO* FindFIFO(uint16_t aAddr)
+{
+    uint8_t i;
+
+    for (i = 0; i < sUnit->mFIFOQty; i++)
+    {
+        if (aAddr == sUnit->mFIFOs[i].mAddress)
+        {
+            return sUnit->mFIFOs + i;
+        }
+    }
+
+    return NULL;
+}
+
+Modbus_Slave_Range* FindRange(Modbus_Slave_Range* aRanges, uint8_t aRangeQty, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(0 < aCount);
+
+    uint32_t lEnd = (uint32_t)aAddr + aCount;
+
+    uint8_t i;
+
+    for (i = 0; i < aRangeQty; i++)
+    {
+        uint16_t lRA = aRanges[i].mAddress;
+
+        if ((lRA <= aAddr) && (((uint32_t)lRA + aRanges[i].mCount) >= lEnd))
+        {
+            return aRanges + i;
+        }
+    }
+
+    return NULL;
+}
+
+Modbus_Slave_Range* FindRecords(uint16_t aFile, uint16_t aRecord, uint16_t aCount)
+{
+    uint8_t i;
+
+    // assert(0 < aCount);
+
+    // The last record must also be valid
+    if ((FILE_RECORD_MAX < aRecord) || (FILE_RECORD_MAX - aRecord < aCount - 1))
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < sUnit->mFileQty; i++)
+    {
+        const Modbus_Slave_File* lFile = sUnit->mFiles + i;
+
+        if (aFile == lFile->mNumber)
+        {
+            return FindRange(lFile->mRanges, lFile->mRangeQty, aRecord, aCount);
+        }
+    }
+
+    return NULL;
+}
+
+const Modbus_Slave_Route* FindRoute(uint8_t aDevice)
+{
+    uint8_t i;
+
+    for (i = 0; i < sRouteQty; i++)
+    {
+        if ((sRoutes[i].mFirst <= aDevice) && (sRoutes[i].mLast >= aDevice))
+        {
+            return sRoutes + i;
+        }
+    }
+
+    return NULL;
+}
+
+const Modbus_Slave_Unit* FindUnit(uint8_t aDevice)
+{
+    uint8_t lIndex;
+
+    if (UNIT_ID_QTY <= aDevice)
+    {
+        return NULL;
+    }
+
+    lIndex = sUnitIndex[aDevice];
+    switch (lIndex)
+    {
+    case UNIT_NONE: return NULL;
+    case UNIT_MAIN: return &sUnitMain;
+    }
+
+    return sUnits + (lIndex - UNIT_FIRST);
+}
+
+uint16_t Forward()
+{
+    // assert(NULL != sRoute);
+
+    uint8_t  lRet;
+    uint16_t lSize_byte = sCount + sizeof(uint16_t); // CRC
+
+    if (NULL == sRoute->mForward)
+    {
+        return Exception(MODBUS_EXCEPTION_GATEWAY_PATH_UNAVAILABLE);
+    }
+
+    lRet = sRoute->mForward(sRoute->mContext, sBuffer, &lSize_byte, sizeof(sBuffer));
+    switch (lRet)
+    {
+    case MODBUS_NO_ERROR: lSize_byte -= sizeof(uint16_t); break; // CRC
+
+    case MODBUS_SLAVE_PENDING: lSize_byte = 0; break;
+
+    default: lSize_byte = Exception(lRet);
+    }
+
+    return lSize_byte;
+}
+
+uint8_t IsAddressed(uint8_t aDevice)
+{
+    return (MODBUS_DEVICE_BROADCAST == aDevice) || (NULL != FindUnit(aDevice)) || (NULL != FindRoute(aDevice));
+}
+
+uint8_t IsBroadcastFunction()
+{
+    switch (sBuffer[MODBUS_BYTE_FUNCTION])
+    {
+    case MODBUS_FUNCTION_MASK_WRITE_REGISTER     :
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_COILS    :
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS:
+    case MODBUS_FUNCTION_WRITE_SINGLE_COIL       :
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER   :
+        return 1;
+    }
+
+    return 0;
+}
+
+uint8_t IsFastRequest(const uint8_t* aFrame)
+{
+    const Modbus_Slave_Range* lRange;
+    const Modbus_Slave_Unit*  lUnit;
+    uint16_t                  lAddr;
+    uint16_t                  lCount;
+
+    switch (aFrame[MODBUS_BYTE_FUNCTION])
+    {
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+    case MODBUS_FUNCTION_READ_INPUT_REGISTERS  : break;
+
+    default: return 0;
+    }
+
+    // Broadcast and forwarded requests are not for a unit
+    lUnit = FindUnit(aFrame[MODBUS_BYTE_DEVICE]);
+    if (NULL == lUnit)
+    {
+        return 0;
+    }
+
+    lAddr  = aFrame[2];
+    lCount = aFrame[4];
+
+    lAddr  <<= 8;
+    lAddr |= aFrame[3];
+
+    lCount <<= 8;
+    lCount |= aFrame[5];
+
+    if ((0 == lCount) || (READ_REGISTERS_MAX < lCount))
+    {
+        return 0;
+    }
+
+    // Only Modbus_Slave_Callback_Default is known not to block
+    lRange = FindRange(lUnit->mRanges, lUnit->mRangeQty, lAddr, lCount);
+
+    return (NULL != lRange) && (Modbus_Slave_Callback_Default == lRange->mAfterRead);
+}
+
+uint16_t Overruns()
+{
+    if (RTU_Receive != sTransport.mReceive)
+    {
+        return 0;
+    }
+
+    return UART_Overruns(sUART) - sOverrunBase;
+}
+
+void ParseRequest()
+{
+    sCounters.mBusMessages++;
+
+    // Device, Function. Forward and Seal need 2 bytes after the frame.
+    if ((2 <= sCount) && ((sizeof(sBuffer) - sizeof(uint16_t)) >= sCount))
+    {
+        sCallDone    = 0;
+        sCallPending = 0;
+        sNoResponse  = 0;
+        sPending_ms = 0;
+        sRoute      = NULL;
+        sUnit       = FindUnit(sBuffer[MODBUS_BYTE_DEVICE]);
+
+        if (MODBUS_DEVICE_BROADCAST == sBuffer[MODBUS_BYTE_DEVICE])
+        {
+            sCounters.mServerMessages++;
+            sCounters.mServerNoResponses++;
+
+            if (IsBroadcastFunction())
+            {
+                // The request is executed but the master does not wait
+                // for a response.
+                sNoResponse = 1;
+                sUnit       = &sUnitMain;
+
+                ProcessRequest();
+            }
+            else
+            {
+                sState = STATE_RECEIVING;
+            }
+        }
+        else if (NULL != sUnit)
+        {
+            sCounters.mServerMessages++;
+
+            ProcessRequest();
+        }
+        else
+        {
+            sRoute = FindRoute(sBuffer[MODBUS_BYTE_DEVICE]);
+            if (NULL == sRoute)
+            {
+                sState = STATE_RECEIVING;
+            }
+            else
+            {
+                // The forward functions use RTU frames, whatever the
+                // transport. The forward function writes the response in
+                // sBuffer, so the CRC is added once, before the first call.
+                Modbus_CRC_Compute_Buffer(sBuffer, sCount);
+
+                ProcessRequest();
+            }
+        }
+    }
+    else
+    {
+        sCounters.mBusCommErrors++;
+
+        sState = STATE_RECEIVING;
+    }
+}
+
+// Device 0x08 SubH SubL DataH DataL
+uint16_t Parse_DIAGNOSTICS()
+{
+    uint16_t lSub   = sBuffer[2];
+    uint16_t lValue = sBuffer[4];
+
+    lSub <<= 8;
+    lSub |= sBuffer[3];
+
+    lValue <<= 8;
+    lValue |= sBuffer[5];
+
+    if (MODBUS_DIAGNOSTICS_RETURN_QUERY_DATA == lSub)
+    {
+        return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, SubFunction, Data
+    }
+
+    if (0 != lValue)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    switch (lSub)
+    {
+    case MODBUS_DIAGNOSTICS_CLEAR_COUNTERS:
+        memset(&sCounters, 0, sizeof(sCounters));
+        sOverrunBase += Overruns();
+        break;
+
+    case MODBUS_DIAGNOSTICS_CLEAR_OVERRUN: sOverrunBase += Overruns(); break;
+
+    case MODBUS_DIAGNOSTICS_BUS_CHARACTER_OVERRUN_COUNT: lValue = Overruns()                   ; break;
+    case MODBUS_DIAGNOSTICS_BUS_COMM_ERROR_COUNT       : lValue = sCounters.mBusCommErrors    ; break;
+    case MODBUS_DIAGNOSTICS_BUS_EXCEPTION_COUNT        : lValue = sCounters.mBusExceptions    ; break;
+    case MODBUS_DIAGNOSTICS_BUS_MESSAGE_COUNT          : lValue = sCounters.mBusMessages      ; break;
+    case MODBUS_DIAGNOSTICS_SERVER_BUSY_COUNT          : lValue = sCounters.mServerBusy       ; break;
+    case MODBUS_DIAGNOSTICS_SERVER_MESSAGE_COUNT       : lValue = sCounters.mServerMessages   ; break;
+    case MODBUS_DIAGNOSTICS_SERVER_NO_RESPONSE_COUNT   : lValue = sCounters.mServerNoResponses; break;
+
+    default: return Exception(MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+    }
+
+    sBuffer[4] = (uint8_t)(lValue >> 8);
+    sBuffer[5] = (uint8_t) lValue;
+
+    return 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, SubFunction, Data
+}
+
+// Device 0x16 AddrH AddrL AndH AndL OrH OrL
+uint16_t Parse_MASK_WRITE_REGISTER()
+{
+    uint16_t lAddr = sBuffer[2];
+    uint16_t lAnd  = sBuffer[4];
+    uint16_t lOr   = sBuffer[6];
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lAnd <<= 8;
+    lAnd |= sBuffer[5];
+
+    lOr <<= 8;
+    lOr |= sBuffer[7];
+
+    return Execute_MASK_WRITE_REGISTER(lAddr, lAnd, lOr);
+}
+
+// Device 0x01 AddrH AddrL CountH CountL
+uint16_t Parse_READ_COILS()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lCount = sBuffer[4];
+
+    lAddr  <<= 8;
+    lAddr |= sBuffer[3];
+
+    lCount <<= 8;
+    lCount |= sBuffer[5];
+
+    return Execute_READ_BITS(sUnit->mCoils, sUnit->mCoilQty, lAddr, lCount);
+}
+
+// Device 0x02 AddrH AddrL CountH CountL
+uint16_t Parse_READ_DISCRETE_INPUTS()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lCount = sBuffer[4];
+
+    lAddr  <<= 8;
+    lAddr |= sBuffer[3];
+
+    lCount <<= 8;
+    lCount |= sBuffer[5];
+
+    return Execute_READ_BITS(sUnit->mInputs, sUnit->mInputQty, lAddr, lCount);
+}
+
+// Device 0x18 AddrH AddrL
+uint16_t Parse_READ_FIFO_QUEUE()
+{
+    uint16_t           lAddr  = sBuffer[2];
+    uint16_t           lByte  = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, ByteCount, FIFOCount
+    uint16_t           lCount = 0;
+    Modbus_Slave_FIFO* lFIFO;
+    uint16_t           lIn;
+    uint16_t           lOut;
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lFIFO = FindFIFO(lAddr);
+    if (NULL == lFIFO)
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    // Values pushed during the copy wait for the next request
+    lIn  = lFIFO->mIn;
+    lOut = lFIFO->mOut;
+
+    while ((lIn != lOut) && (FIFO_COUNT_MAX > lCount))
+    {
+        uint16_t lValue = lFIFO->mData[lOut];
+
+        sBuffer[lByte    ] = (uint8_t)(lValue >> 8);
+        sBuffer[lByte + 1] = (uint8_t) lValue;
+
+        lByte += sizeof(uint16_t);
+        lCount++;
+
+        lOut++;
+        if (lFIFO->mSize <= lOut)
+        {
+            lOut = 0;
+        }
+    }
+
+    // Release the entries only after the copy
+    lFIFO->mOut = lOut;
+
+    sBuffer[2] = 0;
+    sBuffer[3] = (uint8_t)(sizeof(uint16_t) + sizeof(uint16_t) * lCount); // FIFOCount, Data
+    sBuffer[4] = 0;
+    sBuffer[5] = (uint8_t)lCount;
+
+    return lByte;
+}
+
+// Device 0x14 ByteCount { 0x06 FileH FileL RecordH RecordL LengthH LengthL } ...
+uint16_t Parse_READ_FILE_RECORD()
+{
+    uint16_t lByte;
+    uint16_t lCount = 0; // Words of the answer in sData
+
+    if ((7 > sBuffer[2]) || (FILE_DATA_MAX_byte < sBuffer[2]) || (0 != (sBuffer[2] % 7)))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    for (lByte = 3; lByte < sCount; lByte += 7)
+    {
+        uint16_t            lFile   = sBuffer[lByte + 1];
+        uint16_t            lLength = sBuffer[lByte + 5];
+        Modbus_Slave_Range* lRange;
+        uint16_t            lRecord = sBuffer[lByte + 3];
+        uint8_t             lRet;
+
+        lFile <<= 8;
+        lFile |= sBuffer[lByte + 2];
+
+        lRecord <<= 8;
+        lRecord |= sBuffer[lByte + 4];
+
+        lLength <<= 8;
+        lLength |= sBuffer[lByte + 6];
+
+        if ((FILE_REFERENCE_TYPE != sBuffer[lByte]) || (0 == lLength) || (READ_REGISTERS_MAX < lLength)
+            || (READ_REGISTERS_MAX < lCount + 1 + lLength)
+            || (FILE_DATA_MAX_byte < sizeof(uint16_t) * (lCount + 1 + lLength)))
+        {
+            return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+        }
+
+        lRange = FindRecords(lFile, lRecord, lLength);
+        if (NULL == lRange)
+        {
+            return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+        }
+
+        // File response length, Reference type
+        sData[lCount] = ((1 + sizeof(uint16_t) * lLength) << 8) | FILE_REFERENCE_TYPE;
+
+        // The records of each sub-request follow its header in sData. The
+        // records of the completed sub-requests stay there while a later
+        // one is pending.
+        sDataFirst = lCount + 1;
+
+        lRet = Range_Read(lRange, lRecord, lLength);
+        if (MODBUS_NO_ERROR != lRet)
+        {
+            return Exception(lRet);
+        }
+
+        lCount = sDataFirst + lLength;
+    }
+
+    return Data_Put(lCount);
+}
+
+// Device 0x03 AddrH AddrL CountH CountL
+// Device 0x04 AddrH AddrL CountH CountL
+uint16_t Parse_READ_REGISTERS()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lCount = sBuffer[4];
+
+    lAddr  <<= 8;
+    lAddr |= sBuffer[3];
+
+    lCount <<= 8;
+    lCount |= sBuffer[5];
+
+    return Execute_READ_REGISTERS(lAddr, lCount);
+}
+
+// Device 0x17 ReadAddrH ReadAddrL ReadCountH ReadCountL WriteAddrH WriteAddrL
+//             WriteCountH WriteCountL ByteCount ...
+uint16_t Parse_READ_WRITE_MULTIPLE_REGISTERS()
+{
+    uint16_t lReadAddr   = sBuffer[2];
+    uint16_t lReadCount  = sBuffer[4];
+    uint16_t lWriteAddr  = sBuffer[6];
+    uint16_t lWriteCount = sBuffer[8];
+
+    lReadAddr <<= 8;
+    lReadAddr |= sBuffer[3];
+
+    lReadCount <<= 8;
+    lReadCount |= sBuffer[5];
+
+    lWriteAddr <<= 8;
+    lWriteAddr |= sBuffer[7];
+
+    lWriteCount <<= 8;
+    lWriteCount |= sBuffer[9];
+
+    return Execute_READ_WRITE_MULTIPLE_REGISTERS(lReadAddr, lReadCount, lWriteAddr, lWriteCount);
+}
+
+// Device 0x15 ByteCount { 0x06 FileH FileL RecordH RecordL LengthH LengthL ... } ...
+uint16_t Parse_WRITE_FILE_RECORD()
+{
+    uint16_t lByte = 3;
+
+    if ((9 > sBuffer[2]) || (FILE_DATA_MAX_byte < sBuffer[2]))
+    {
+        return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+
+    while (lByte < sCount)
+    {
+        uint16_t            lFile;
+        uint16_t            lLength;
+        Modbus_Slave_Range* lRange;
+        uint16_t            lRecord;
+        uint8_t             lRet;
+
+        if (sCount < lByte + 7)
+        {
+            return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+        }
+
+        lFile   = sBuffer[lByte + 1];
+        lRecord = sBuffer[lByte + 3];
+        lLength = sBuffer[lByte + 5];
+
+        lFile <<= 8;
+        lFile |= sBuffer[lByte + 2];
+
+        lRecord <<= 8;
+        lRecord |= sBuffer[lByte + 4];
+
+        lLength <<= 8;
+        lLength |= sBuffer[lByte + 6];
+
+        if ((FILE_REFERENCE_TYPE != sBuffer[lByte]) || (0 == lLength) || (WRITE_REGISTERS_MAX < lLength)
+            || (sCount < lByte + 7 + sizeof(uint16_t) * lLength))
+        {
+            return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+        }
+
+        lRange = FindRecords(lFile, lRecord, lLength);
+        if (NULL == lRange)
+        {
+            return Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+        }
+
+        Data_Get(lByte + 7, lLength);
+
+        lRet = Range_Write(lRange, lRecord, lLength);
+        if (MODBUS_NO_ERROR != lRet)
+        {
+            return Exception(lRet);
+        }
+
+        lByte += 7 + sizeof(uint16_t) * lLength;
+    }
+
+    // The response is a copy of the request
+    return sCount;
+}
+
+// Device 0x0f AddrH AddrL CountH CountL ByteCount ...
+uint16_t Parse_WRITE_MULTIPLE_COILS()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lCount = sBuffer[4];
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lCount <<= 8;
+    lCount |= sBuffer[5];
+
+    return Execute_WRITE_MULTIPLE_COILS(lAddr, lCount);
+}
+
+// Device 0x10 AddrH AddrL CountH CountL ByteCount ...
+uint16_t Parse_WRITE_MULTIPLE_REGISTERS()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lCount = sBuffer[4];
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lCount <<= 8;
+    lCount |= sBuffer[5];
+
+    return Execute_WRITE_MULTIPLE_REGISTERS(lAddr, lCount);
+}
+
+// Device 0x05 AddrH AddrL ValueH ValueL
+uint16_t Parse_WRITE_SINGLE_COIL()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lValue = sBuffer[4];
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lValue <<= 8;
+    lValue |= sBuffer[5];
+
+    return Execute_WRITE_SINGLE_COIL(lAddr, lValue);
+}
+
+// Device 0x06 AddrH AddrL ValueH ValueL
+uint16_t Parse_WRITE_SINGLE_REGISTER()
+{
+    uint16_t lAddr  = sBuffer[2];
+    uint16_t lValue = sBuffer[4];
+
+    lAddr <<= 8;
+    lAddr |= sBuffer[3];
+
+    lValue <<= 8;
+    lValue |= sBuffer[5];
+
+    return Execute_WRITE_SINGLE_REGISTER(lAddr, lValue);
+}
+
+void ProcessRequest()
+{
+    uint16_t lExpected_byte = RequestSize();
+    uint16_t lSize_byte;
+
+    sCache     = NULL;
+    sCallIndex = 0;
+    sDataFirst = 0;
+    sResponse  = sBuffer;
+
+    if (NULL != sRoute)
+    {
+        lSize_byte = Forward();
+    }
+    else if (0 == lExpected_byte)
+    {
+        lSize_byte = Exception(MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+    }
+    else if (sCount != lExpected_byte)
+    {
+        lSize_byte = Exception(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+    }
+    else switch (sBuffer[MODBUS_BYTE_FUNCTION])
+    {
+    case MODBUS_FUNCTION_DIAGNOSTICS: lSize_byte = Parse_DIAGNOSTICS(); break;
+
+    case MODBUS_FUNCTION_READ_COILS          : lSize_byte = Parse_READ_COILS          (); break;
+    case MODBUS_FUNCTION_READ_DISCRETE_INPUTS: lSize_byte = Parse_READ_DISCRETE_INPUTS(); break;
+
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+    case MODBUS_FUNCTION_READ_INPUT_REGISTERS  : lSize_byte = Parse_READ_REGISTERS(); break;
+
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_COILS: lSize_byte = Parse_WRITE_MULTIPLE_COILS(); break;
+    case MODBUS_FUNCTION_WRITE_SINGLE_COIL   : lSize_byte = Parse_WRITE_SINGLE_COIL   (); break;
+
+    case MODBUS_FUNCTION_MASK_WRITE_REGISTER          : lSize_byte = Parse_MASK_WRITE_REGISTER          (); break;
+    case MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS: lSize_byte = Parse_READ_WRITE_MULTIPLE_REGISTERS(); break;
+
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS: lSize_byte = Parse_WRITE_MULTIPLE_REGISTERS(); break;
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER   : lSize_byte = Parse_WRITE_SINGLE_REGISTER   (); break;
+
+    case MODBUS_FUNCTION_READ_FIFO_QUEUE  : lSize_byte = Parse_READ_FIFO_QUEUE  (); break;
+    case MODBUS_FUNCTION_READ_FILE_RECORD : lSize_byte = Parse_READ_FILE_RECORD (); break;
+    case MODBUS_FUNCTION_WRITE_FILE_RECORD: lSize_byte = Parse_WRITE_FILE_RECORD(); break;
+
+    default: lSize_byte = Exception(MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+    }
+
+    if (0 == lSize_byte)
+    {
+        sState = STATE_PENDING;
+        return;
+    }
+
+    if (sNoResponse)
+    {
+        // Broadcast request, or the master already received the pending
+        // timeout exception
+        sState = STATE_RECEIVING;
+        return;
+    }
+
+    // A cached response is already sealed
+    if (sBuffer == sResponse)
+    {
+        lSize_byte = Seal(sBuffer, lSize_byte);
+
+        if (NULL != sCache)
+        {
+            Cache_Fill(lSize_byte);
+        }
+    }
+
+    Set_SENDING(lSize_byte);
+}
+
+uint16_t RequestSize()
+{
+    uint16_t lResult_byte = 0;
+
+    switch (sBuffer[MODBUS_BYTE_FUNCTION])
+    {
+    case MODBUS_FUNCTION_READ_COILS            :
+    case MODBUS_FUNCTION_READ_DISCRETE_INPUTS  :
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+    case MODBUS_FUNCTION_READ_INPUT_REGISTERS  :
+        lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Count
+        break;
+
+    case MODBUS_FUNCTION_DIAGNOSTICS:
+        lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, SubFunction, Data
+        break;
+
+    case MODBUS_FUNCTION_READ_FIFO_QUEUE:
+        lResult_byte = 1 + 1 + sizeof(uint16_t); // Device, Function, Address
+        break;
+
+    case MODBUS_FUNCTION_WRITE_SINGLE_COIL    :
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER:
+        lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t); // Device, Function, Address, Value
+        break;
+
+    case MODBUS_FUNCTION_MASK_WRITE_REGISTER:
+        lResult_byte = 1 + 1 + 3 * sizeof(uint16_t); // Device, Function, Address, And, Or
+        break;
+
+    case MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS:
+        lResult_byte = 1 + 1 + 4 * sizeof(uint16_t) + 1; // Device, Function, ReadAddress, ReadCount, WriteAddress, WriteCount, Size_byte
+        if (lResult_byte <= sCount)
+        {
+            lResult_byte += sBuffer[10];
+        }
+        break;
+
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_COILS    :
+    case MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS:
+        lResult_byte = 1 + 1 + sizeof(uint16_t) + sizeof(uint16_t) + 1; // Device, Function, Address, Count, Size_byte
+        if (lResult_byte <= sCount)
+        {
+            lResult_byte += sBuffer[6];
+        }
+        break;
+
+    case MODBUS_FUNCTION_READ_FILE_RECORD :
+    case MODBUS_FUNCTION_WRITE_FILE_RECORD:
+        lResult_byte = 1 + 1 + 1; // Device, Function, Size_byte
+        if (lResult_byte <= sCount)
+        {
+            lResult_byte += sBuffer[2];
+        }
+        break;
+    }
+
+    return lResult_byte;
+}
+
+uint8_t Range_Read(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+
+    uint16_t*    lOut = sData + sDataFirst;
+    uint8_t      lCommits;
+    unsigned int i;
+
+    if (Replaying())
+    {
+        return Call(aRange->mAfterRead, aRange, aAddr, aCount);
+    }
+
+    if (Retrying())
+    {
+        return Stats_Update(aRange, 0, aCount, Call(aRange->mAfterRead, aRange, aAddr, aCount));
+    }
+
+    // Modbus_Slave_Commit may swap the buffers during the copy. In this
+    // case, the copy restarts from the new buffer.
+    do
+    {
+        const uint16_t* lData;
+
+        lCommits = aRange->mCommits;
+        lData    = aRange->mData;
+
+        if (NULL == lData)
+        {
+            for (i = 0; i < aCount; i++)
+            {
+                lOut[i] = 0;
+            }
+        }
+        else
+        {
+            uint16_t lIndex = aAddr - aRange->mAddress;
+
+            for (i = 0; i < aCount; i++)
+            {
+                lOut[i] = lData[lIndex + i];
+            }
+        }
+    }
+    while (lCommits != aRange->mCommits);
+
+    return Stats_Update(aRange, 0, aCount, Call(aRange->mAfterRead, aRange, aAddr, aCount));
+}
+
+uint8_t Range_ReadBits(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
+{
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+
+    uint8_t      lCommits;
+    uint16_t     lSize_word = (aCount + 15) / 16;
+    unsigned int i;
+
+    if (Replaying())
+    {
+        return Call(aRange->mAfterRead, aRange, aAddr, aCount);
+    }
+
+    if (Retrying())
+    {
+        return Stats_Update(aRange, 0, aCount, Call(aRange->mAfterRead, aRange, aAddr, aCount));
+    }
+
+    // See Range_Read
+    do
+    {
+        const uint16_t* lData;
+
+        lCommits = aRange->mCommits;
+        lData    = aRange->mData;
+
+        for (i = 0; i < lSize_word; i++)
+        {
+            sData[i] = 0;
+        }
+
+        if (NULL != lData)
+        {
+            uint16_t lIndex = aAddr - aRange->mAddress;
+
+            for (i = 0; i < aCount; i++)
+            {
+                uint16_t lBit = lIndex + i;
+
+                if (0 != (lData[lBit / 16] & (1 << (lBit % 16))))
+                {
+                    sData[i / 16] |= 1 << (i % 16);
+                }
+            }
+        }
+    }
+    while (lCommits != aRange->mCommits);
+
+    return Stats_Update(aRange, 0, aCount, Call(aRange->mAfterRead, aRange, aAddr, aCount));
 }
 
-// Device 0x06 AddrH AddrL ValueH ValueL
-uint8_t Parse_WRITE_SINGLE_REGISTER()
+uint8_t Range_Write(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
 {
-    uint16_t lAddr  = sBuffer[2];
-    uint16_t lValue = sBuffer[4];
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
 
-    lAddr <<= 8;
-    lAddr |= sBuffer[3];
+    uint8_t lRet;
 
-    lValue <<= 8;
-    lValue |= sBuffer[5];
+    unsigned int i;
 
-    return Execute_WRITE_SINGLE_REGISTER(lAddr, lValue);
+    Modbus_Slave_Publish(aRange);
+
+    lRet = Call(aRange->mBeforeWrite, aRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        // A replayed callback returns MODBUS_NO_ERROR
+        return Stats_Update(aRange, 1, aCount, lRet);
+    }
+
+    Dirty_Set(aRange, aAddr, aCount);
+
+    if ((NULL != aRange->mData) && (!Replaying()))
+    {
+        uint16_t lIndex = aAddr - aRange->mAddress;
+
+        for (i = 0; i < aCount; i++)
+        {
+            aRange->mData[lIndex + i] = sData[sDataFirst + i];
+        }
+    }
+
+    if (Replaying())
+    {
+        return Call(aRange->mAfterWrite, aRange, aAddr, aCount);
+    }
+
+    return Stats_Update(aRange, 1, aCount, Call(aRange->mAfterWrite, aRange, aAddr, aCount));
 }
 
-void Set_WAITING()
+uint8_t Range_WriteBits(Modbus_Slave_Range* aRange, uint16_t aAddr, uint16_t aCount)
 {
-    UART_Read(sUART, sBuffer, sizeof(sBuffer));
+    // assert(NULL != aRange);
+    // assert(0 < aCount);
+
+    uint8_t lRet;
+
+    unsigned int i;
+
+    Modbus_Slave_Publish(aRange);
+
+    lRet = Call(aRange->mBeforeWrite, aRange, aAddr, aCount);
+    if (MODBUS_NO_ERROR != lRet)
+    {
+        // A replayed callback returns MODBUS_NO_ERROR
+        return Stats_Update(aRange, 1, aCount, lRet);
+    }
+
+    Dirty_Set(aRange, aAddr, aCount);
+
+    if ((NULL != aRange->mData) && (!Replaying()))
+    {
+        uint16_t lIndex = aAddr - aRange->mAddress;
+
+        for (i = 0; i < aCount; i++)
+        {
+            uint16_t lBit  = lIndex + i;
+            uint16_t lMask = 1 << (lBit % 16);
+
+            if (0 != (sData[i / 16] & (1 << (i % 16))))
+            {
+                aRange->mData[lBit / 16] |= lMask;
+            }
+            else
+            {
+                aRange->mData[lBit / 16] &= ~ lMask;
+            }
+        }
+    }
+
+    if (Replaying())
+    {
+        return Call(aRange->mAfterWrite, aRange, aAddr, aCount);
+    }
 
-    sState = STATE_WAITING;
+    return Stats_Update(aRange, 1, aCount, Call(aRange->mAfterWrite, aRange, aAddr, aCount));
 }
 
-void Set_WRITING(uint8_t aSize_byte)
+uint8_t Replaying()
 {
-    // assert(4 <= aSize_byte);
+    return sCallIndex < sCallDone;
+}
 
-    GPIO_Output(sOutputEnable, 1);
+uint8_t Retrying()
+{
+    return sCallPending && (sCallIndex == sCallDone);
+}
+
+uint16_t Seal(uint8_t* aFrame, uint16_t aSize_byte)
+{
+    if (NULL == sTransport.mSeal)
+    {
+        return aSize_byte;
+    }
+
+    return sTransport.mSeal(sTransport.mContext, aFrame, aSize_byte);
+}
+
+void Set_PENDING_Expired()
+{
+    uint8_t* lR = sPendingResponse;
+
+    lR[MODBUS_BYTE_DEVICE   ] = sBuffer[MODBUS_BYTE_DEVICE];
+    lR[MODBUS_BYTE_FUNCTION ] = sBuffer[MODBUS_BYTE_FUNCTION] | MODBUS_FUNCTION_ERROR;
+    lR[MODBUS_BYTE_EXCEPTION] = sPendingException;
+
+    sCounters.mBusExceptions++;
+
+    if (MODBUS_EXCEPTION_SERVER_DEVICE_BUSY == sPendingException)
+    {
+        sCounters.mServerBusy++;
+    }
+
+    // Work_SENDING goes back to PENDING to complete the request. A
+    // callback returning MODBUS_SLAVE_PENDING may still use sData, an
+    // EEPROM access for example, so it is not abandoned.
+    sNoResponse = 1;
+    sResponse   = lR;
+
+    Set_SENDING(Seal(lR, 1 + 1 + 1)); // Device, Function, Exception
+}
+
+void Set_SENDING(uint16_t aSize_byte)
+{
+    sTransport.mSend(sTransport.mContext, sResponse, aSize_byte);
+
+    sState = STATE_SENDING;
+}
+
+uint8_t Stats_Update(Modbus_Slave_Range* aRange, uint8_t aWrite, uint16_t aCount, uint8_t aResult)
+{
+    Modbus_Slave_Stats* lStats = aRange->mStats;
+
+    if ((NULL != lStats) && (MODBUS_SLAVE_PENDING != aResult))
+    {
+        if (MODBUS_NO_ERROR != aResult)
+        {
+            lStats->mExceptions++;
+        }
+        else
+        {
+            if (aWrite)
+            {
+                lStats->mWrites++;
+            }
+            else
+            {
+                lStats->mReads++;
+            }
+
+            lStats->mRegisters += aCount;
+        }
+
+        lStats->mAccess_ms = sTime_ms;
+    }
 
-    UART_Write(sUART, sBuffer, aSize_byte);
+    return aResult;
+}
 
-    sState = STATE_WRITING;
+void Work_PENDING()
+{
+    ProcessRequest();
 }
 
-void Work_READING()
+void Work_RECEIVING()
 {
-    uint8_t lCount;
+    uint16_t lSize_byte;
 
-    switch (UART_Status(sUART, UART_READ, &lCount))
+    sFastLock = 1;
     {
-    case UART_ERROR: sState = STATE_ERROR; break;
+        lSize_byte = sTransport.mReceive(sTransport.mContext, sBuffer, sizeof(sBuffer));
 
-    case UART_PENDING:
-        if (sCount < lCount)
+        if (0 < lSize_byte)
         {
-            sCount = lCount;
+            sCount = lSize_byte;
 
             ParseRequest();
         }
+    }
+    sFastLock = 0;
+}
+
+void Work_SENDING()
+{
+    switch (sTransport.mSent(sTransport.mContext))
+    {
+    case MODBUS_NO_ERROR:
+        if (sNoResponse)
+        {
+            sState = STATE_PENDING;
+        }
+        else
+        {
+            sState = STATE_RECEIVING;
+        }
         break;
 
-    // default: assert(false);
+    case MODBUS_SLAVE_PENDING: break;
+
+    default: sState = STATE_ERROR;
     }
 }
 
-void Work_WAITING()
+// ===== RTU transport ======================================================
+
+uint8_t RTU_Collect()
 {
-    uint8_t lCount;
+    uint16_t lEntry = sRxNext;
 
-    switch (UART_Status(sUART, UART_READ, &lCount))
+    for (;;)
     {
-    case UART_ERROR: sState = STATE_ERROR; break;
+        if ((NO_ENTRY == lEntry) && (0 == UART_Stream_Read(sUART, &lEntry, 1)))
+        {
+            sRxNext = NO_ENTRY;
+            return 0;
+        }
 
-    case UART_PENDING:
-        if (0 < lCount)
+        // The silence before the entry ends the current frame
+        if ((0 < sRxCount) && (0 != (lEntry & UART_STREAM_GAP)))
         {
-            UART_SetTimeout(sUART, UART_READ, TIMEOUT_ms);
+            sRxNext = lEntry;
+            return 1;
+        }
 
-            sCount         = lCount;
-            sExpectedCount = UNKNOWN_EXPECTED_COUNT;
-            sState         = STATE_READING;
+        RTU_Store(lEntry);
 
-            ParseRequest();
+        lEntry = NO_ENTRY;
+    }
+}
+
+void RTU_Fast()
+{
+    if ((STATE_RECEIVING != sState) || (!sRxStarted))
+    {
+        return;
+    }
+
+    RTU_Collect();
+
+    // The size of these requests is known, the 3.5 character silence is
+    // not needed to find their end. A silence of more than 1.5 characters
+    // already ended the frame.
+    if ((FAST_REQUEST_SIZE_byte != sRxCount) || sSkipping || sBroken)
+    {
+        return;
+    }
+
+    if ((!Modbus_CRC_Verify_Buffer(sRxFrame, sRxCount)) || (!IsFastRequest(sRxFrame)))
+    {
+        return;
+    }
+
+    sRxStarted = 0;
+
+    // sRxFrame is sBuffer
+    sCount = sRxCount - sizeof(uint16_t); // CRC
+
+    ParseRequest();
+}
+
+void RTU_Flush()
+{
+    uint16_t lEntries[8];
+
+    while (0 < UART_Stream_Read(sUART, lEntries, sizeof(lEntries) / sizeof(lEntries[0])))
+    {
+    }
+
+    sRxNext = NO_ENTRY;
+}
+
+uint16_t RTU_Receive(void* aContext, uint8_t* aFrame, uint16_t aFrameSize_byte)
+{
+    // RTU_RxData processed the request before Work_RECEIVING took the lock
+    if (STATE_RECEIVING != sState)
+    {
+        return 0;
+    }
+
+    if (!sRxStarted)
+    {
+        RTU_Start(aFrame, aFrameSize_byte);
+    }
+
+    // RTU_RxData ignores the bytes received while Work_RECEIVING has the
+    // lock.
+    if (sFast)
+    {
+        RTU_Fast();
+
+        if (STATE_RECEIVING != sState)
+        {
+            return 0;
         }
-        break;
+    }
 
-    // default: assert(false);
+    // The frame ends after a silence of 3.5 characters, or when the bytes
+    // of the next frame are already received. A silence of more than 1.5
+    // characters inside the frame also ends it, its CRC is then invalid.
+    if (!RTU_Collect())
+    {
+        // Wait for the first byte
+        if (0 == sRxCount)
+        {
+            return 0;
+        }
+
+        if (sT35_us > UART_Silence_us(sUART))
+        {
+            return 0;
+        }
+    }
+
+    // Device, Function, CRC
+    if ((!sSkipping) && (!sBroken) && (4 <= sRxCount) && Modbus_CRC_Verify_Buffer(aFrame, sRxCount))
+    {
+        sRxStarted = 0;
+
+        return sRxCount - sizeof(uint16_t); // CRC
+    }
+
+    sCounters.mBusMessages++;
+
+    if (!sSkipping)
+    {
+        sCounters.mBusCommErrors++;
+    }
+
+    // The next frame may already be received
+    sBroken   = 0;
+    sRxCount  = 0;
+    sSkipping = 0;
+
+    return 0;
+}
+
+void RTU_RxData(void* aContext)
+{
+    if (!sFastLock)
+    {
+        RTU_Fast();
+    }
+}
+
+uint16_t RTU_Seal(void* aContext, uint8_t* aFrame, uint16_t aSize_byte)
+{
+    Modbus_CRC_Compute_Buffer(aFrame, aSize_byte);
+
+    return aSize_byte + sizeof(uint16_t); // CRC
+}
+
+void RTU_Send(void* aContext, const uint8_t* aFrame, uint16_t aSize_byte)
+{
+    // assert(4 <= aSize_byte);
+
+    uint8_t  lIndex      = 0;
+    uint16_t lLatency_us = UART_Silence_us(sUART);
+
+    while (((MODBUS_SLAVE_LATENCY_QTY - 1) > lIndex) && ((LATENCY_FIRST_us << lIndex) <= lLatency_us))
+    {
+        lIndex++;
     }
+
+    sCounters.mLatency[lIndex]++;
+
+    GPIO_Output(sOutputEnable, 1);
+
+    UART_Write(sUART, aFrame, aSize_byte);
 }
 
-void Work_WRITING()
+uint8_t RTU_Sent(void* aContext)
 {
-    uint8_t lCount;
+    uint16_t lCount;
 
     switch (UART_Status(sUART, UART_WRITE, &lCount))
     {
-    case UART_ERROR:
-        GPIO_Output(sOutputEnable, 0);
-        sState = STATE_ERROR;
-        break;
+    case UART_ERROR: break;
 
-    case UART_PENDING: break;
+    case UART_PENDING: return MODBUS_SLAVE_PENDING;
 
-    case UART_SUCCESS:
-        GPIO_Output(sOutputEnable, 0);
-        Set_WAITING();
-        break;
+    // RTU_TxComplete already released the output
+    case UART_SUCCESS: return MODBUS_NO_ERROR;
+
+    // default: assert(false);
+    }
+
+    GPIO_Output(sOutputEnable, 0);
+
+    return MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE;
+}
+
+void RTU_Start(uint8_t* aFrame, uint16_t aFrameSize_byte)
+{
+    uint16_t lChar_us = UART_CharTime_us(sUART);
+    uint16_t lT15_us;
+
+    if (FIXED_TIMES_bps < UART_Rate_bps(sUART))
+    {
+        lT15_us = FIXED_T15_us;
+        sT35_us = FIXED_T35_us;
+    }
+    else
+    {
+        lT15_us = (3 * lChar_us) / 2;
+        sT35_us = (7 * lChar_us) / 2;
+    }
+
+    // The stream starts here, after the UART_Configure following
+    // Modbus_Slave_Init. It restarts when the rate changes.
+    if (sT15_us != lT15_us)
+    {
+        sT15_us = lT15_us;
+
+        UART_Stream_Start(sUART, sStream, MODBUS_SLAVE_STREAM_SIZE, sT15_us);
+
+        sRxKeep = 0;
+        sRxNext = NO_ENTRY;
+    }
+
+    // The bytes received since RTU_TxComplete may be the next request. The
+    // other ones were received while processing the previous request.
+    if (!sRxKeep)
+    {
+        RTU_Flush();
+    }
+
+    sRxFrame          = aFrame;
+    sRxFrameSize_byte = aFrameSize_byte;
+
+    sBroken    = 0;
+    sRxCount   = 0;
+    sRxKeep    = 0;
+    sRxStarted = 1;
+    sSkipping  = 0;
+}
+
+void RTU_Store(uint16_t aEntry)
+{
+    uint8_t lByte = (uint8_t)aEntry;
+
+    if (0 == sRxCount)
+    {
+        // A frame starts after a silence. Without it, the start of the
+        // frame was flushed. The rest of such a frame, or of a frame for
+        // another slave, is neither stored nor verified.
+        if ((0 == (aEntry & UART_STREAM_GAP)) || (!IsAddressed(lByte)))
+        {
+            sRxCount  = 1;
+            sSkipping = 1;
+        }
+    }
+    else if (0 != (aEntry & UART_STREAM_ERROR))
+    {
+        // The error flag of the first byte is about the silence before it
+        sBroken = 1;
+    }
+
+    if (sSkipping)
+    {
+        return;
+    }
+
+    if (sRxFrameSize_byte <= sRxCount)
+    {
+        sBroken = 1; // The frame is too long
+        return;
+    }
+
+    sRxFrame[sRxCount] = lByte;
+    sRxCount++;
+}
+
+void RTU_Tick(void* aContext, uint16_t aPeriod_ms)
+{
+    // The read side is also ticked while a request is pending, to keep
+    // UART_Silence_us valid for the latency measurement.
+    UART_Tick(sUART, UART_READ , aPeriod_ms);
+    UART_Tick(sUART, UART_WRITE, aPeriod_ms);
+
+    // The bytes received while a request is pending are not a request the
+    // slave can process. Dropping them avoids the stream overruns.
+    switch (sState)
+    {
+    case STATE_ERROR  :
+    case STATE_INIT   :
+    case STATE_PENDING: RTU_Flush(); break;
+
+    case STATE_RECEIVING:
+    case STATE_SENDING  : break;
 
     // default: assert(false);
     }
 }
+
+void RTU_TxComplete(void* aContext)
+{
+    // GPIO_Output is interrupt safe, the application may use the other
+    // bits of the port.
+    GPIO_Output(sOutputEnable, 0);
+
+    // The bytes received until the end of the response are not a request.
+    // After the pending timeout exception, the pending request is still
+    // processed and RTU_Tick flushes the stream.
+    if (!sNoResponse)
+    {
+        RTU_Flush();
+
+        sRxKeep = 1;
+    }
+}
@@ -0,0 +1,168 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Sources/Modbus_Slave_EEPROM.c
+
+// Assumptions
+// //////////////////////////////////////////////////////////////////////////
+//
+// - The EEPROM functions are called from the same context as
+//   Modbus_Slave_Work.
+
+// CodeWarrior
+// //////////////////////////////////////////////////////////////////////////
+//
+// Project configuration
+// - Also add EEPROM.c to the project
+// - Also add Modbus_Slave.c to the project
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdlib.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+
+#include "Modbus_Slave_EEPROM.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return  EEPROM address of aAddress
+static uint8_t Address(Modbus_Slave_Range* aRange, uint16_t aAddress);
+
+// Convert the registers to EEPROM bytes, in place
+static void Pack(uint16_t* aData, uint16_t aCount);
+
+// Return  MODBUS_NO_ERROR
+//         MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE
+//         MODBUS_SLAVE_PENDING
+static uint8_t Status(Modbus_Slave_EEPROM* aThis);
+
+// Convert the EEPROM bytes to registers, in place
+static void Unpack(uint16_t* aData, uint16_t aCount);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t Modbus_Slave_Callback_EEPROM_Read(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    // assert(NULL != aRange);
+    // assert(NULL != aRange->mContext);
+    // assert(NULL != aData);
+
+    Modbus_Slave_EEPROM* lThis = aRange->mContext;
+    uint8_t              lResult;
+
+    if (!lThis->mStarted)
+    {
+        // The application may be using the EEPROM
+        if (EEPROM_Idle(lThis->mEEPROM))
+        {
+            EEPROM_Read(lThis->mEEPROM, Address(aRange, aAddress), aData, sizeof(uint16_t) * aCount);
+            lThis->mStarted = 1;
+        }
+
+        return MODBUS_SLAVE_PENDING;
+    }
+
+    lResult = Status(lThis);
+    if (MODBUS_NO_ERROR == lResult)
+    {
+        Unpack(aData, aCount);
+    }
+
+    return lResult;
+}
+
+uint8_t Modbus_Slave_Callback_EEPROM_Write(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    // assert(NULL != aRange);
+    // assert(NULL != aRange->mContext);
+    // assert(NULL != aData);
+
+    Modbus_Slave_EEPROM* lThis = aRange->mContext;
+    uint8_t              lResult;
+
+    if (!lThis->mStarted)
+    {
+        if (EEPROM_Idle(lThis->mEEPROM))
+        {
+            Pack(aData, aCount);
+
+            EEPROM_Write(lThis->mEEPROM, Address(aRange, aAddress), aData, sizeof(uint16_t) * aCount);
+            lThis->mStarted = 1;
+        }
+
+        return MODBUS_SLAVE_PENDING;
+    }
+
+    lResult = Status(lThis);
+    if (MODBUS_SLAVE_PENDING != lResult)
+    {
+        // Restore the registers for the other callbacks
+        Unpack(aData, aCount);
+    }
+
+    return lResult;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t Address(Modbus_Slave_Range* aRange, uint16_t aAddress)
+{
+    const Modbus_Slave_EEPROM* lThis = aRange->mContext;
+
+    return (uint8_t)(lThis->mAddress + sizeof(uint16_t) * (aAddress - aRange->mAddress));
+}
+
+void Pack(uint16_t* aData, uint16_t aCount)
+{
+    uint8_t* lBytes = (uint8_t*)aData;
+
+    unsigned int i;
+
+    for (i = 0; i < aCount; i++)
+    {
+        uint16_t lValue = aData[i];
+
+        lBytes[2 * i    ] = (uint8_t)(lValue >> 8);
+        lBytes[2 * i + 1] = (uint8_t) lValue;
+    }
+}
+
+uint8_t Status(Modbus_Slave_EEPROM* aThis)
+{
+    switch (EEPROM_Status(aThis->mEEPROM))
+    {
+    case EEPROM_PENDING: return MODBUS_SLAVE_PENDING;
+
+    case EEPROM_SUCCESS:
+        aThis->mStarted = 0;
+        return MODBUS_NO_ERROR;
+    }
+
+    aThis->mStarted = 0;
+
+    return MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE;
+}
+
+void Unpack(uint16_t* aData, uint16_t aCount)
+{
+    const uint8_t* lBytes = (uint8_t*)aData;
+
+    unsigned int i;
+
+    for (i = 0; i < aCount; i++)
+    {
+        uint16_t lValue = lBytes[2 * i];
+
+        lValue <<= 8;
+        lValue |= lBytes[2 * i + 1];
+
+        aData[i] = lValue;
+    }
+}
@@ -0,0 +1,501 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Stub.c
+
+// The stub follows the behavior Includes/UART.h documents, as implemented
+// by Sources/MC56F/QSCI.c. Each received byte is processed by its own
+// receive interrupt.
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Tick.h"
+#include "UART.h"
+
+#include "Stub.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define CLOCK_Hz (80000000)
+
+#define OUT_SIZE_byte (512)
+
+#define PORT_QTY (7)
+
+#define SILENCE_MAX_us (0x7fff)
+
+#define UART_QTY (3)
+
+// Write timeout, see Sources/MC56F/QSCI.c
+#define WRITE_TIMEOUT_FACTOR (4)
+#define WRITE_TIMEOUT_MIN_ms (20)
+
+// Value of the mState members, the other values are UART_ERROR,
+// UART_PENDING and UART_SUCCESS
+#define STATE_IDLE (0xff)
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    uint32_t mRate_bps;
+    uint16_t mChar_us;
+
+    UART_Callback mRxData;
+    void        * mRxData_Context;
+    UART_Callback mTxComplete;
+    void        * mTxComplete_Context;
+
+    uint8_t* mIn;
+    uint16_t mInCount;
+    uint16_t mInGap_us;
+    uint16_t mInSize_byte;
+    uint8_t  mInState;
+    uint16_t mInTimeout_ms;
+
+    uint32_t mLast_us;
+    uint16_t mOverruns;
+    uint8_t  mQuiet;
+
+    uint16_t* mStream;
+    uint16_t  mStreamFlags;
+    uint16_t  mStreamGap_us;
+    uint16_t  mStreamIn;
+    uint16_t  mStreamOut;
+    uint16_t  mStreamSize;
+
+    uint8_t  mOut[OUT_SIZE_byte];
+    uint16_t mOutCount;
+    uint32_t mOutEnd_us;
+    uint8_t  mOutStall;
+    uint8_t  mOutState;
+    uint16_t mOutTimeout_ms;
+}
+Context;
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static Context  sContexts[UART_QTY];
+static uint32_t sNow_us;
+static uint16_t sOutputs[PORT_QTY];
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint32_t Silence_us(Context* aThis);
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Stub_Init()
+{
+    memset(&sContexts, 0, sizeof(sContexts));
+    memset(&sOutputs , 0, sizeof(sOutputs ));
+
+    sNow_us = 0;
+}
+
+uint8_t Stub_Output(GPIO aDesc)
+{
+    return (0 != (sOutputs[aDesc.mPort] & (1 << aDesc.mBit)));
+}
+
+void Stub_Receive_Byte(uint8_t aIndex, uint8_t aByte, uint8_t aError)
+{
+    Context* lThis = sContexts + aIndex;
+
+    if (NULL != lThis->mStream)
+    {
+        uint16_t lNext = lThis->mStreamIn + 1;
+
+        if ((lThis->mQuiet) || (lThis->mStreamGap_us <= Silence_us(lThis)))
+        {
+            lThis->mStreamFlags |= UART_STREAM_GAP;
+        }
+
+        if (aError)
+        {
+            lThis->mStreamFlags |= UART_STREAM_ERROR;
+        }
+
+        if (lThis->mStreamSize <= lNext)
+        {
+            lNext = 0;
+        }
+
+        if (lThis->mStreamOut == lNext)
+        {
+            lThis->mOverruns++;
+            lThis->mStreamFlags |= UART_STREAM_ERROR;
+        }
+        else
+        {
+            lThis->mStream[lThis->mStreamIn] = aByte | lThis->mStreamFlags;
+            lThis->mStreamIn    = lNext;
+            lThis->mStreamFlags = 0;
+        }
+    }
+    else if (STATE_IDLE != lThis->mInState)
+    {
+        if ((0 < lThis->mInCount) && (lThis->mInGap_us < Silence_us(lThis)))
+        {
+            lThis->mInGap_us = (uint16_t)Silence_us(lThis);
+        }
+
+        if (aError || (UART_PENDING != lThis->mInState))
+        {
+            lThis->mInState = UART_ERROR;
+        }
+        else
+        {
+            lThis->mIn[lThis->mInCount] = aByte;
+            lThis->mInCount++;
+
+            if (lThis->mInSize_byte <= lThis->mInCount)
+            {
+                lThis->mInState = UART_SUCCESS;
+            }
+        }
+    }
+
+    lThis->mLast_us = sNow_us;
+    lThis->mQuiet   = 0;
+
+    if (NULL != lThis->mRxData)
+    {
+        lThis->mRxData(lThis->mRxData_Context);
+    }
+}
+
+void Stub_Receive(uint8_t aIndex, const uint8_t* aIn, uint16_t aInSize_byte, uint32_t aSilence_us)
+{
+    Context* lThis = sContexts + aIndex;
+
+    unsigned int i;
+
+    Stub_Wait(aSilence_us);
+
+    for (i = 0; i < aInSize_byte; i++)
+    {
+        Stub_Wait(lThis->mChar_us);
+
+        Stub_Receive_Byte(aIndex, aIn[i], 0);
+    }
+}
+
+uint16_t Stub_Sent(uint8_t aIndex, uint8_t* aOut, uint16_t aOutSize_byte)
+{
+    Context* lThis   = sContexts + aIndex;
+    uint16_t lResult = lThis->mOutCount;
+
+    if (aOutSize_byte < lResult)
+    {
+        lResult = aOutSize_byte;
+    }
+
+    memcpy(aOut, lThis->mOut, lResult);
+
+    lThis->mOutCount = 0;
+
+    return lResult;
+}
+
+void Stub_Stall(uint8_t aIndex, uint8_t aStall)
+{
+    sContexts[aIndex].mOutStall = aStall;
+}
+
+void Stub_Wait(uint32_t aDelay_us)
+{
+    uint32_t lEnd_us = sNow_us + aDelay_us;
+
+    unsigned int i;
+
+    for (i = 0; i < UART_QTY; i++)
+    {
+        Context* lThis = sContexts + i;
+
+        if ((UART_PENDING == lThis->mOutState) && (!lThis->mOutStall) && (lThis->mOutEnd_us <= lEnd_us))
+        {
+            sNow_us = lThis->mOutEnd_us;
+
+            lThis->mOutState = UART_SUCCESS;
+
+            if (NULL != lThis->mTxComplete)
+            {
+                lThis->mTxComplete(lThis->mTxComplete_Context);
+            }
+        }
+    }
+
+    sNow_us = lEnd_us;
+}
+
+// ===== GPIO.c =============================================================
+
+void GPIO_Output(GPIO aDesc, uint8_t aValue)
+{
+    if (aValue)
+    {
+        sOutputs[aDesc.mPort] |=   1 << aDesc.mBit;
+    }
+    else
+    {
+        sOutputs[aDesc.mPort] &= ~ (1 << aDesc.mBit);
+    }
+}
+
+// ===== QSCI.c =============================================================
+
+void UART_Init(uint8_t aIndex)
+{
+    Context* lThis = sContexts + aIndex;
+
+    memset(lThis, 0, sizeof(*lThis));
+
+    lThis->mInState  = STATE_IDLE;
+    lThis->mLast_us  = sNow_us;
+    lThis->mOutState = STATE_IDLE;
+    lThis->mQuiet    = 1;
+
+    UART_Configure(aIndex, 19200, UART_PARITY_NONE, 1);
+}
+
+uint16_t UART_CharTime_us(uint8_t aIndex)
+{
+    return sContexts[aIndex].mChar_us;
+}
+
+void UART_Configure(uint8_t aIndex, uint32_t aRate_bps, uint8_t aParity, uint8_t aStopBits)
+{
+    Context* lThis = sContexts + aIndex;
+    uint32_t lBits = 10;
+    uint32_t lRate = (CLOCK_Hz + aRate_bps) / (2 * aRate_bps);
+
+    if (UART_PARITY_NONE != aParity)
+    {
+        lBits++;
+    }
+
+    if (2 == aStopBits)
+    {
+        lBits++;
+    }
+
+    lThis->mRate_bps = CLOCK_Hz / (2 * lRate);
+    lThis->mChar_us  = (uint16_t)((1000000 * lBits + lThis->mRate_bps - 1) / lThis->mRate_bps);
+}
+
+uint16_t UART_Gap_us(uint8_t aIndex)
+{
+    return sContexts[aIndex].mInGap_us;
+}
+
+void UART_Abort(uint8_t aIndex, uint8_t aOp)
+{
+    Context* lThis = sContexts + aIndex;
+
+    if (UART_READ == aOp)
+    {
+        lThis->mIn      = NULL;
+        lThis->mInState = STATE_IDLE;
+        lThis->mStream  = NULL;
+    }
+    else
+    {
+        lThis->mOutState = STATE_IDLE;
+    }
+}
+
+uint8_t UART_Idle(uint8_t aIndex, uint8_t aOp)
+{
+    Context* lThis = sContexts + aIndex;
+
+    return STATE_IDLE == ((UART_READ == aOp) ? lThis->mInState : lThis->mOutState);
+}
+
+uint32_t UART_Rate_bps(uint8_t aIndex)
+{
+    return sContexts[aIndex].mRate_bps;
+}
+
+uint16_t UART_Overruns(uint8_t aIndex)
+{
+    return sContexts[aIndex].mOverruns;
+}
+
+void UART_SetRxData(uint8_t aIndex, UART_Callback aCallback, void* aContext)
+{
+    sContexts[aIndex].mRxData         = aCallback;
+    sContexts[aIndex].mRxData_Context = aContext;
+}
+
+void UART_SetTimeout(uint8_t aIndex, uint8_t aOp, uint16_t aTimeout_ms)
+{
+    if (UART_READ == aOp)
+    {
+        sContexts[aIndex].mInTimeout_ms = aTimeout_ms;
+    }
+    else
+    {
+        sContexts[aIndex].mOutTimeout_ms = aTimeout_ms;
+    }
+}
+
+void UART_SetTxComplete(uint8_t aIndex, UART_Callback aCallback, void* aContext)
+{
+    sContexts[aIndex].mTxComplete         = aCallback;
+    sContexts[aIndex].mTxComplete_Context = aContext;
+}
+
+void UART_Read(uint8_t aIndex, void* aOut, uint16_t aOutSize_byte)
+{
+    Context* lThis = sContexts + aIndex;
+
+    lThis->mIn           = aOut;
+    lThis->mInCount      = 0;
+    lThis->mInGap_us     = 0;
+    lThis->mInSize_byte  = aOutSize_byte;
+    lThis->mInState      = UART_PENDING;
+    lThis->mInTimeout_ms = 0;
+}
+
+uint16_t UART_Silence_us(uint8_t aIndex)
+{
+    return (uint16_t)Silence_us(sContexts + aIndex);
+}
+
+uint8_t UART_Status(uint8_t aIndex, uint8_t aOp, uint16_t* aCount)
+{
+    Context* lThis   = sContexts + aIndex;
+    uint8_t* lState  = (UART_READ == aOp) ? &lThis->mInState : &lThis->mOutState;
+    uint8_t  lResult = *lState;
+
+    *aCount = (UART_READ == aOp) ? lThis->mInCount : lThis->mOutCount;
+
+    switch (lResult)
+    {
+    case UART_PENDING: break;
+
+    case UART_ERROR  :
+    case UART_SUCCESS: *lState = STATE_IDLE; break;
+
+    default: lResult = UART_ERROR;
+    }
+
+    return lResult;
+}
+
+uint16_t UART_Stream_Read(uint8_t aIndex, uint16_t* aOut, uint16_t aOutSize)
+{
+    Context* lThis  = sContexts + aIndex;
+    uint16_t lCount = 0;
+
+    if (NULL == lThis->mStream)
+    {
+        return 0;
+    }
+
+    while ((aOutSize > lCount) && (lThis->mStreamIn != lThis->mStreamOut))
+    {
+        aOut[lCount] = lThis->mStream[lThis->mStreamOut];
+        lCount++;
+
+        lThis->mStreamOut++;
+        if (lThis->mStreamSize <= lThis->mStreamOut)
+        {
+            lThis->mStreamOut = 0;
+        }
+    }
+
+    return lCount;
+}
+
+void UART_Stream_Start(uint8_t aIndex, uint16_t* aBuffer, uint16_t aSize, uint16_t aGap_us)
+{
+    Context* lThis = sContexts + aIndex;
+
+    lThis->mIn      = NULL;
+    lThis->mInState = STATE_IDLE;
+
+    lThis->mStream       = aBuffer;
+    lThis->mStreamFlags  = UART_STREAM_GAP;
+    lThis->mStreamGap_us = aGap_us;
+    lThis->mStreamIn     = 0;
+    lThis->mStreamOut    = 0;
+    lThis->mStreamSize   = aSize;
+}
+
+void UART_Tick(uint8_t aIndex, uint8_t aOp, uint16_t aPeriod_ms)
+{
+    Context * lThis     = sContexts + aIndex;
+    uint8_t * lState    = (UART_READ == aOp) ? &lThis->mInState      : &lThis->mOutState;
+    uint16_t* lTimeout  = (UART_READ == aOp) ? &lThis->mInTimeout_ms : &lThis->mOutTimeout_ms;
+
+    if ((UART_PENDING == *lState) && (0 < *lTimeout))
+    {
+        if (*lTimeout <= aPeriod_ms)
+        {
+            *lState   = UART_ERROR;
+            *lTimeout = 0;
+        }
+        else
+        {
+            *lTimeout -= aPeriod_ms;
+        }
+    }
+}
+
+void UART_Write(uint8_t aIndex, const void* aIn, uint16_t aInSize_byte)
+{
+    Context* lThis = sContexts + aIndex;
+
+    if (OUT_SIZE_byte >= lThis->mOutCount + aInSize_byte)
+    {
+        memcpy(lThis->mOut + lThis->mOutCount, aIn, aInSize_byte);
+
+        lThis->mOutCount += aInSize_byte;
+    }
+
+    lThis->mOutEnd_us     = sNow_us + (uint32_t)lThis->mChar_us * aInSize_byte;
+    lThis->mOutState      = UART_PENDING;
+    lThis->mOutTimeout_ms = (uint16_t)((WRITE_TIMEOUT_FACTOR * (uint32_t)lThis->mChar_us * aInSize_byte) / 1000 + 1);
+
+    // QSCI.c replaces the timeout with a longer one when the last byte is
+    // in the transmitter. The stub keeps it until the end of the write.
+    if (WRITE_TIMEOUT_MIN_ms > lThis->mOutTimeout_ms)
+    {
+        lThis->mOutTimeout_ms = WRITE_TIMEOUT_MIN_ms;
+    }
+}
+
+// ===== Tick.c =============================================================
+
+uint16_t Tick_Now_us()
+{
+    return (uint16_t)sNow_us;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint32_t Silence_us(Context* aThis)
+{
+    uint32_t lResult_us = sNow_us - aThis->mLast_us;
+
+    if (aThis->mQuiet || (SILENCE_MAX_us < lResult_us))
+    {
+        lResult_us = SILENCE_MAX_us;
+    }
+
+    return lResult_us;
+}
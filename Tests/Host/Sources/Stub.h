@@ -0,0 +1,46 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Stub.h
+
+// The stub replaces GPIO.c, QSCI.c and Tick.c. The time is simulated, it
+// only advances when the test calls Stub_Wait or Stub_Receive. The
+// interrupt handlers are called from these two functions.
+
+#pragma once
+
+// ===== Includes ===========================================================
+#include "GPIO.h"
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+extern void Stub_Init();
+
+// Return  The last value GPIO_Output wrote to the pin
+extern uint8_t Stub_Output(GPIO aDesc);
+
+// aError  Receive this byte with an error, a framing error for example
+//
+// Receive a byte now, without advancing the time
+extern void Stub_Receive_Byte(uint8_t aIndex, uint8_t aByte, uint8_t aError);
+
+// aSilence_us  Silence before the first byte
+//
+// Receive the bytes, one character time apart
+extern void Stub_Receive(uint8_t aIndex, const uint8_t* aIn, uint16_t aInSize_byte, uint32_t aSilence_us);
+
+// aOut  The function puts the bytes written since the last call there
+//
+// Return  The number of bytes written since the last call
+extern uint16_t Stub_Sent(uint8_t aIndex, uint8_t* aOut, uint16_t aOutSize_byte);
+
+// aStall  The write operations do not end, UART_Tick reports their
+//         timeout. The bytes are still recorded for Stub_Sent.
+extern void Stub_Stall(uint8_t aIndex, uint8_t aStall);
+
+// Advance the time. The write operations end when their last byte left the
+// transmitter.
+extern void Stub_Wait(uint32_t aDelay_us);
@@ -0,0 +1,115 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test.c
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The silence before the requests, more than 3.5 characters
+#define REQUEST_SILENCE_us (5000)
+
+// Delay given to the slave to process a request and send the response. The
+// longest response, 256 bytes, lasts 147 ms at 19200 bps.
+#define RESPONSE_DELAY_ms (160)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int sChecks;
+static unsigned int sErrors;
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Test_Check(int aCondition, const char* aFile, unsigned int aLine, const char* aText)
+{
+    sChecks++;
+
+    if (!aCondition)
+    {
+        fprintf(stderr, "%s(%u): Check failed - %s\n", aFile, aLine, aText);
+
+        sErrors++;
+    }
+}
+
+int Test_Result(const char* aName)
+{
+    printf("%s: %u checks, %u errors\n", aName, sChecks, sErrors);
+
+    return (0 == sErrors) ? 0 : 1;
+}
+
+void Test_Slave_CheckException(const uint8_t* aResponse, uint16_t aSize_byte, uint8_t aFunction, uint8_t aException)
+{
+    TEST_CHECK(5 == aSize_byte);
+    TEST_CHECK((5 <= aSize_byte) && Modbus_CRC_Verify_Buffer(aResponse, aSize_byte));
+    TEST_CHECK((MODBUS_FUNCTION_ERROR | aFunction) == aResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK(aException == aResponse[MODBUS_BYTE_EXCEPTION]);
+}
+
+void Test_Slave_Init(Modbus_Slave_Range* aRanges, uint8_t aRangeQty)
+{
+    GPIO lOutputEnable;
+
+    memset(&lOutputEnable, 0, sizeof(lOutputEnable));
+
+    lOutputEnable.mBit  = 3;
+    lOutputEnable.mPort = GPIO_PORT_C;
+
+    Stub_Init();
+
+    Modbus_Slave_Init(TEST_UART, 1, aRanges, aRangeQty, lOutputEnable);
+}
+
+uint16_t Test_Slave_Request(const uint8_t* aRequest, uint16_t aRequestSize_byte, uint8_t* aResponse, uint16_t aResponseSize_byte)
+{
+    uint8_t lFrame[MODBUS_ADU_MAX_byte];
+
+    memcpy(lFrame, aRequest, aRequestSize_byte);
+
+    Modbus_CRC_Compute_Buffer(lFrame, aRequestSize_byte);
+
+    // Drop what the slave sent before
+    Stub_Sent(TEST_UART, aResponse, aResponseSize_byte);
+
+    Stub_Receive(TEST_UART, lFrame, aRequestSize_byte + sizeof(uint16_t), REQUEST_SILENCE_us);
+
+    Test_Slave_Run(RESPONSE_DELAY_ms);
+
+    return Stub_Sent(TEST_UART, aResponse, aResponseSize_byte);
+}
+
+void Test_Slave_Run(uint16_t aDuration_ms)
+{
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < aDuration_ms; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            Stub_Wait(250);
+
+            Modbus_Slave_Work();
+        }
+
+        Modbus_Slave_Tick(1);
+    }
+}
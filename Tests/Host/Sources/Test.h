@@ -0,0 +1,44 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test.h
+
+#pragma once
+
+// Macros
+// //////////////////////////////////////////////////////////////////////////
+
+#define TEST_CHECK(C) Test_Check((C), __FILE__, __LINE__, #C)
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The slave under test uses this UART
+#define TEST_UART (0)
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+extern void Test_Check(int aCondition, const char* aFile, unsigned int aLine, const char* aText);
+
+// Return  The exit code of the test program
+extern int Test_Result(const char* aName);
+
+// aResponse  The response, CRC included
+//
+// Check the response is a valid exception response
+extern void Test_Slave_CheckException(const uint8_t* aResponse, uint16_t aSize_byte, uint8_t aFunction, uint8_t aException);
+
+// Initialize the stub and the slave, device 1
+extern void Test_Slave_Init(Modbus_Slave_Range* aRanges, uint8_t aRangeQty);
+
+// aRequest  The request without its CRC. The function adds it.
+// aResponse The function puts the response there, CRC included
+//
+// Return  The size of the response, 0 when the slave does not respond
+extern uint16_t Test_Slave_Request(const uint8_t* aRequest, uint16_t aRequestSize_byte, uint8_t* aResponse, uint16_t aResponseSize_byte);
+
+// Call Modbus_Slave_Work every 250 us and Modbus_Slave_Tick every ms
+extern void Test_Slave_Run(uint16_t aDuration_ms);
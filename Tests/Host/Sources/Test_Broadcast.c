@@ -0,0 +1,126 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Broadcast.c
+
+// Broadcast requests (unit ID 0)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint8_t AfterWrite(Modbus_Slave_Range* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+static void Broadcast_Error ();
+static void Broadcast_Ignore();
+static void Broadcast_Write ();
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int sAfterWrite;
+
+static uint16_t sRegisters[4];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, sRegisters, Modbus_Slave_Callback_Default, AfterWrite, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Broadcast_Write ();
+    Broadcast_Ignore();
+    Broadcast_Error ();
+
+    return Test_Result("Test_Broadcast");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t AfterWrite(Modbus_Slave_Range* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    sAfterWrite++;
+
+    return MODBUS_NO_ERROR;
+}
+
+// A write past the end of the range gets an exception, which is not sent
+void Broadcast_Error()
+{
+    static const uint8_t REQUEST[] = { MODBUS_DEVICE_BROADCAST, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 4, 0x12, 0x34 };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(0 == lSize_byte);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(1 == lCounters.mBusExceptions);
+    TEST_CHECK(4 == lCounters.mServerNoResponses);
+}
+
+// A broadcast read is ignored. The next request for the slave is
+// processed as usual.
+void Broadcast_Ignore()
+{
+    static const uint8_t BROADCAST[] = { MODBUS_DEVICE_BROADCAST, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+    static const uint8_t READ     [] = { 1                      , MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 1 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(BROADCAST, sizeof(BROADCAST), lResponse, sizeof(lResponse));
+    TEST_CHECK(0 == lSize_byte);
+
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    TEST_CHECK(7 == lSize_byte);
+    TEST_CHECK((7 == lSize_byte) && (0x12 == lResponse[3]) && (0x34 == lResponse[4]));
+}
+
+// FC06 and FC16 broadcasts are executed without response
+void Broadcast_Write()
+{
+    static const uint8_t SINGLE  [] = { MODBUS_DEVICE_BROADCAST, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER   , 0, 1, 0x12, 0x34 };
+    static const uint8_t MULTIPLE[] = { MODBUS_DEVICE_BROADCAST, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 2, 0, 2, 4, 0x56, 0x78, 0x9a, 0xbc };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    lSize_byte = Test_Slave_Request(SINGLE, sizeof(SINGLE), lResponse, sizeof(lResponse));
+    TEST_CHECK(0 == lSize_byte);
+    TEST_CHECK(0x1234 == sRegisters[1]);
+    TEST_CHECK(1 == sAfterWrite);
+
+    lSize_byte = Test_Slave_Request(MULTIPLE, sizeof(MULTIPLE), lResponse, sizeof(lResponse));
+    TEST_CHECK(0 == lSize_byte);
+    TEST_CHECK((0x5678 == sRegisters[2]) && (0x9abc == sRegisters[3]));
+    TEST_CHECK(2 == sAfterWrite);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(2 == lCounters.mServerMessages);
+    TEST_CHECK(2 == lCounters.mServerNoResponses);
+    TEST_CHECK(0 == lCounters.mBusExceptions);
+}
@@ -0,0 +1,151 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Cache.c
+
+// Response cache of a read range
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Read registers 0 and 1
+static const uint8_t READ_0[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 2 };
+
+// Read registers 2 and 3
+static const uint8_t READ_2[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 2, 0, 2 };
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static uint8_t AfterRead(Modbus_Slave_Range* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+// aValue  The expected value of the first register
+static void Read(const uint8_t* aRequest, uint16_t aValue);
+
+static void Hit    ();
+static void Publish();
+static void Write  ();
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int sAfterRead;
+
+static uint8_t sFrame[16];
+
+static Modbus_Slave_Cache sCache = { sFrame, sizeof(sFrame) };
+
+static uint16_t sRegisters[4];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, sRegisters, AfterRead, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, &sCache, NULL, 0, NULL, NULL },
+};
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Hit    ();
+    Publish();
+    Write  ();
+
+    return Test_Result("Test_Cache");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t AfterRead(Modbus_Slave_Range* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    sAfterRead++;
+
+    return MODBUS_NO_ERROR;
+}
+
+void Read(const uint8_t* aRequest, uint16_t aValue)
+{
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(aRequest, 6, lResponse, sizeof(lResponse));
+    TEST_CHECK(9 == lSize_byte);
+    TEST_CHECK((9 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_READ_HOLDING_REGISTERS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK((uint8_t)(aValue >> 8) == lResponse[3]);
+    TEST_CHECK((uint8_t) aValue       == lResponse[4]);
+}
+
+// The same read is answered from the cache, mAfterRead is not called and
+// the data changed without Modbus_Slave_Publish are not seen. Another read
+// replaces the cached response.
+void Hit()
+{
+    sRegisters[0] = 0x1111;
+    sRegisters[2] = 0x2222;
+
+    Read(READ_0, 0x1111);
+    TEST_CHECK(1 == sAfterRead);
+
+    sRegisters[0] = 0x3333;
+
+    Read(READ_0, 0x1111);
+    TEST_CHECK(1 == sAfterRead);
+
+    Read(READ_2, 0x2222);
+    TEST_CHECK(2 == sAfterRead);
+
+    Read(READ_0, 0x3333);
+    TEST_CHECK(3 == sAfterRead);
+
+    Read(READ_0, 0x3333);
+    TEST_CHECK(3 == sAfterRead);
+}
+
+// Modbus_Slave_Publish discards the cached response
+void Publish()
+{
+    sRegisters[0] = 0x4444;
+
+    Modbus_Slave_Publish(sRanges + 0);
+
+    Read(READ_0, 0x4444);
+    TEST_CHECK(4 == sAfterRead);
+
+    Read(READ_0, 0x4444);
+    TEST_CHECK(4 == sAfterRead);
+}
+
+// A write through Modbus discards the cached response
+void Write()
+{
+    // Write 0x5555 to register 0
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 0, 0x55, 0x55 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK(0x5555 == sRegisters[0]);
+
+    Read(READ_0, 0x5555);
+    TEST_CHECK(5 == sAfterRead);
+}
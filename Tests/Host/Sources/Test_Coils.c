@@ -0,0 +1,168 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Coils.c
+
+// Coils and discrete inputs (FC01, FC02, FC05 and FC15)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sCoils [2] = { 0xa5c3, 0x00f0 };
+static uint16_t sInputs[1] = { 0x0081 };
+static uint16_t sRegisters[1];
+
+static Modbus_Slave_Range sCoilRanges[1] =
+{
+    { NULL, 100, 24, sCoils, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static Modbus_Slave_Range sInputRanges[1] =
+{
+    { NULL, 0, 8, sInputs, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Error, NULL, NULL, 0, NULL, NULL },
+};
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void ReadCoils();
+static void ReadDiscreteInputs();
+static void WriteMultipleCoils();
+static void WriteSingleCoil();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitBits(sCoilRanges, 1, sInputRanges, 1);
+
+    Test_Slave_Run(10);
+
+    ReadCoils         ();
+    ReadDiscreteInputs();
+    WriteSingleCoil   ();
+    WriteMultipleCoils();
+
+    return Test_Result("Test_Coils");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void ReadCoils()
+{
+    // Coils 110 to 121, bits 10 to 21 of the range, across the 2 words
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_COILS, 0, 110, 0, 12 };
+
+    static const uint8_t COUNT_0[] = { 1, MODBUS_FUNCTION_READ_COILS, 0, 110, 0, 0 };
+    static const uint8_t OUTSIDE[] = { 1, MODBUS_FUNCTION_READ_COILS, 0, 120, 0, 5 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(7 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_READ_COILS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK(2 == lResponse[2]);
+    TEST_CHECK((0x29 == lResponse[3]) && (0x0c == lResponse[4]));
+
+    lSize_byte = Test_Slave_Request(COUNT_0, sizeof(COUNT_0), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_COILS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(OUTSIDE, sizeof(OUTSIDE), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_COILS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+}
+
+void ReadDiscreteInputs()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_DISCRETE_INPUTS, 0, 0, 0, 8 };
+
+    // The coil addresses are not discrete input addresses
+    static const uint8_t COIL[] = { 1, MODBUS_FUNCTION_READ_DISCRETE_INPUTS, 0, 100, 0, 1 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(6 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK((1 == lResponse[2]) && (0x81 == lResponse[3]));
+
+    lSize_byte = Test_Slave_Request(COIL, sizeof(COIL), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_DISCRETE_INPUTS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+}
+
+void WriteMultipleCoils()
+{
+    // Coils 112 to 121, the 9 first ones on
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_COILS, 0, 112, 0, 10, 2, 0xff, 0x01 };
+
+    static const uint8_t BYTE_COUNT[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_COILS, 0, 112, 0, 10, 3, 0xff, 0x01, 0x00 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(BYTE_COUNT, sizeof(BYTE_COUNT), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_MULTIPLE_COILS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK((0 == lResponse[2]) && (112 == lResponse[3]) && (0 == lResponse[4]) && (10 == lResponse[5]));
+
+    // The bits outside the written coils do not change
+    TEST_CHECK(0xf5c3 == sCoils[0]);
+    TEST_CHECK(0x00df == sCoils[1]);
+}
+
+void WriteSingleCoil()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_COIL, 0, 117, 0xff, 0x00 };
+
+    static const uint8_t INVALID[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_COIL, 0, 117, 0x12, 0x34 };
+    static const uint8_t OUTSIDE[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_COIL, 0, 124, 0xff, 0x00 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(REQUEST) + sizeof(uint16_t) == lSize_byte);
+
+    for (i = 0; i < sizeof(REQUEST); i++)
+    {
+        TEST_CHECK(REQUEST[i] == lResponse[i]);
+    }
+
+    TEST_CHECK(0xa5c3 == sCoils[0]);
+    TEST_CHECK(0x00f2 == sCoils[1]);
+
+    lSize_byte = Test_Slave_Request(INVALID, sizeof(INVALID), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_SINGLE_COIL, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(OUTSIDE, sizeof(OUTSIDE), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_SINGLE_COIL, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+}
@@ -0,0 +1,197 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Commit.c
+
+// Double buffered range and Modbus_Slave_Commit. To simulate an interrupt
+// committing during the copy of a read, the second page of the front
+// buffer is protected. The SIGSEGV handler plays the interrupt handler.
+
+#define _POSIX_C_SOURCE (200809L)
+
+// ===== C ==================================================================
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Read registers 0 to 3
+static const uint8_t READ[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 4 };
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t  sBuffer[4];
+static uint8_t * sPages;
+static size_t    sPage_byte;
+static uint16_t* sSplit; // The 2 first registers are on the first page
+
+static unsigned int sFaults;
+
+static uint8_t sFrame[16];
+
+static Modbus_Slave_Cache sCache = { sFrame, sizeof(sFrame) };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, NULL, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, &sCache, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Fill(uint16_t* aData, uint16_t aValue);
+
+// The interrupt handler commits the back buffer, then starts writing the
+// next snapshot to the new back buffer, as the application is allowed to.
+static void OnFault(int aSignal, siginfo_t* aInfo, void* aContext);
+
+// aValue  The expected value of the 4 registers
+static void Read(uint16_t aValue);
+
+static void Commit      ();
+static void Commit_Read ();
+static void Commit_Write();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    struct sigaction lAction;
+
+    sPage_byte = (size_t)sysconf(_SC_PAGESIZE);
+
+    TEST_CHECK(0 == posix_memalign((void**)&sPages, sPage_byte, 2 * sPage_byte));
+
+    sSplit = (uint16_t*)(sPages + sPage_byte) - 2;
+
+    memset(&lAction, 0, sizeof(lAction));
+
+    lAction.sa_flags     = SA_SIGINFO;
+    lAction.sa_sigaction = OnFault;
+
+    sigemptyset(&lAction.sa_mask);
+    sigaction(SIGSEGV, &lAction, NULL);
+
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Commit      ();
+    Commit_Read ();
+    Commit_Write();
+
+    return Test_Result("Test_Commit");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Fill(uint16_t* aData, uint16_t aValue)
+{
+    unsigned int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        aData[i] = aValue;
+    }
+}
+
+void OnFault(int aSignal, siginfo_t* aInfo, void* aContext)
+{
+    sFaults++;
+
+    mprotect(sPages + sPage_byte, sPage_byte, PROT_READ | PROT_WRITE);
+
+    Modbus_Slave_Commit(sRanges + 0);
+
+    Fill(sRanges[0].mBack, 0x3333);
+}
+
+void Read(uint16_t aValue)
+{
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    TEST_CHECK(13 == lSize_byte);
+    TEST_CHECK((13 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+
+    for (i = 0; i < 4; i++)
+    {
+        TEST_CHECK((uint8_t)(aValue >> 8) == lResponse[3 + 2 * i]);
+        TEST_CHECK((uint8_t) aValue       == lResponse[4 + 2 * i]);
+    }
+}
+
+// The reads see the committed snapshot, the cached response included
+void Commit()
+{
+    sRanges[0].mData = sBuffer;
+    sRanges[0].mBack = sSplit;
+
+    Fill(sBuffer, 0x1111);
+
+    Read(0x1111);
+
+    Fill(sSplit, 0x2222);
+
+    Modbus_Slave_Commit(sRanges + 0);
+
+    TEST_CHECK(sSplit  == sRanges[0].mData);
+    TEST_CHECK(sBuffer == sRanges[0].mBack);
+
+    Read(0x2222);
+}
+
+// A commit during the copy restarts it from the new front buffer. Without
+// the restart, the response would mix 0x2222 and 0x3333.
+void Commit_Read()
+{
+    Fill(sBuffer, 0x4444);
+
+    // The cached response must not answer the read
+    Modbus_Slave_Publish(sRanges + 0);
+
+    sFaults = 0;
+
+    mprotect(sPages + sPage_byte, sPage_byte, PROT_NONE);
+
+    Read(0x4444);
+
+    TEST_CHECK(1 == sFaults);
+    TEST_CHECK(sBuffer == sRanges[0].mData);
+}
+
+// The values written through Modbus go to the front buffer only
+void Commit_Write()
+{
+    // Write 0x5555 to register 1
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 1, 0x55, 0x55 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+
+    TEST_CHECK(0x5555 == sBuffer[1]);
+    TEST_CHECK(0x3333 == sSplit [1]);
+}
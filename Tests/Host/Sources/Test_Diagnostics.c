@@ -0,0 +1,164 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Diagnostics.c
+
+// Diagnostics (FC08) counter sub-functions
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters[1];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aData  The data field of the request
+//
+// Return  The data field of the response
+static uint16_t Diagnostics(uint16_t aSub, uint16_t aData);
+
+static void Diagnostics_Counters();
+static void Diagnostics_Invalid ();
+static void Diagnostics_Query   ();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Diagnostics_Query   ();
+    Diagnostics_Invalid ();
+    Diagnostics_Counters();
+
+    return Test_Result("Test_Diagnostics");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// Device 0x08 SubH SubL DataH DataL
+uint16_t Diagnostics(uint16_t aSub, uint16_t aData)
+{
+    uint8_t lRequest[] = { 1, MODBUS_FUNCTION_DIAGNOSTICS, (uint8_t)(aSub >> 8), (uint8_t)aSub, (uint8_t)(aData >> 8), (uint8_t)aData };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(lRequest, sizeof(lRequest), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK((8 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_DIAGNOSTICS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK((lRequest[2] == lResponse[2]) && (lRequest[3] == lResponse[3]));
+
+    return ((uint16_t)lResponse[4] << 8) | lResponse[5];
+}
+
+// Each request for the slave counts as a server message before the
+// counter is read, the counter sub-functions included
+void Diagnostics_Counters()
+{
+    static const uint8_t BROADCAST[] = { MODBUS_DEVICE_BROADCAST, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER , 0, 0, 0x12, 0x34 };
+    static const uint8_t OTHER    [] = { 9                      , MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+    static const uint8_t OUTSIDE  [] = { 1                      , MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 1 };
+    static const uint8_t READ     [] = { 1                      , MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    unsigned int i;
+
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_CLEAR_COUNTERS, 0));
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(0 == lCounters.mBusMessages);
+    TEST_CHECK(0 == lCounters.mServerMessages);
+
+    TEST_CHECK(7 == Test_Slave_Request(READ, sizeof(READ), lFrame, sizeof(lFrame)));
+
+    lSize_byte = Test_Slave_Request(OUTSIDE, sizeof(OUTSIDE), lFrame, sizeof(lFrame));
+    Test_Slave_CheckException(lFrame, lSize_byte, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    TEST_CHECK(0 == Test_Slave_Request(OTHER    , sizeof(OTHER    ), lFrame, sizeof(lFrame)));
+    TEST_CHECK(0 == Test_Slave_Request(BROADCAST, sizeof(BROADCAST), lFrame, sizeof(lFrame)));
+
+    // A request with an invalid CRC
+    for (i = 0; i < sizeof(READ); i++)
+    {
+        lFrame[i] = READ[i];
+    }
+
+    Modbus_CRC_Compute_Buffer(lFrame, sizeof(READ));
+
+    lFrame[sizeof(READ)] ^= 0xff;
+
+    Stub_Receive(TEST_UART, lFrame, sizeof(READ) + sizeof(uint16_t), 5000);
+    Test_Slave_Run(160);
+    TEST_CHECK(0 == Stub_Sent(TEST_UART, lFrame, sizeof(lFrame)));
+
+    // The clear, read and exception responses were sent
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(5 == lCounters.mBusMessages);
+    TEST_CHECK(3 == lCounters.mServerMessages);
+    TEST_CHECK(3 == lCounters.mLatency[0] + lCounters.mLatency[1] + lCounters.mLatency[2] + lCounters.mLatency[3]
+                  + lCounters.mLatency[4] + lCounters.mLatency[5] + lCounters.mLatency[6] + lCounters.mLatency[7]);
+
+    TEST_CHECK(6 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_MESSAGE_COUNT          , 0));
+    TEST_CHECK(1 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_COMM_ERROR_COUNT       , 0));
+    TEST_CHECK(1 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_EXCEPTION_COUNT        , 0));
+    TEST_CHECK(7 == Diagnostics(MODBUS_DIAGNOSTICS_SERVER_MESSAGE_COUNT       , 0));
+    TEST_CHECK(1 == Diagnostics(MODBUS_DIAGNOSTICS_SERVER_NO_RESPONSE_COUNT   , 0));
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_SERVER_BUSY_COUNT          , 0));
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_CHARACTER_OVERRUN_COUNT, 0));
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_CLEAR_OVERRUN              , 0));
+
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_CLEAR_COUNTERS, 0));
+    TEST_CHECK(1 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_MESSAGE_COUNT, 0));
+    TEST_CHECK(0 == Diagnostics(MODBUS_DIAGNOSTICS_BUS_EXCEPTION_COUNT, 0));
+}
+
+// A counter sub-function with data, or an unknown sub-function, gets an
+// exception
+void Diagnostics_Invalid()
+{
+    static const uint8_t DATA   [] = { 1, MODBUS_FUNCTION_DIAGNOSTICS, 0, MODBUS_DIAGNOSTICS_BUS_MESSAGE_COUNT, 0, 1 };
+    static const uint8_t UNKNOWN[] = { 1, MODBUS_FUNCTION_DIAGNOSTICS, 0, 0x13, 0, 0 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(DATA, sizeof(DATA), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_DIAGNOSTICS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(UNKNOWN, sizeof(UNKNOWN), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_DIAGNOSTICS, MODBUS_EXCEPTION_ILLEGAL_FUNCTION);
+}
+
+// Return Query Data echoes the data
+void Diagnostics_Query()
+{
+    TEST_CHECK(0xa55a == Diagnostics(MODBUS_DIAGNOSTICS_RETURN_QUERY_DATA, 0xa55a));
+}
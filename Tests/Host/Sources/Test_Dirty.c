@@ -0,0 +1,186 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Dirty.c
+
+// Registers and coils written through Modbus, Modbus_Slave_NextDirty
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sCoils    [1];
+static uint16_t sReadOnly [1];
+static uint16_t sRegisters[40];
+
+static uint16_t sCoilBits    [1];
+static uint16_t sReadOnlyBits[1];
+static uint16_t sRegisterBits[3];
+
+static Modbus_Slave_Dirty sCoilDirty     = { sCoilBits     };
+static Modbus_Slave_Dirty sReadOnlyDirty = { sReadOnlyBits };
+static Modbus_Slave_Dirty sRegisterDirty = { sRegisterBits };
+
+static Modbus_Slave_Range sCoilRanges[1] =
+{
+    { NULL, 0, 16, sCoils, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, &sCoilDirty, NULL },
+};
+
+static Modbus_Slave_Range sRanges[2] =
+{
+    { NULL, 100, 40, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, &sRegisterDirty, NULL },
+    { NULL, 200,  1, sReadOnly , Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Error  , NULL, NULL, 0, &sReadOnlyDirty, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return  The size of the response
+static uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte);
+
+static void Dirty_Coil    ();
+static void Dirty_Iterate ();
+static void Dirty_Lower   ();
+static void Dirty_Rejected();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 2);
+
+    Modbus_Slave_InitBits(sCoilRanges, 1, NULL, 0);
+
+    Test_Slave_Run(10);
+
+    Dirty_Iterate ();
+    Dirty_Lower   ();
+    Dirty_Rejected();
+    Dirty_Coil    ();
+
+    return Test_Result("Test_Dirty");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte)
+{
+    uint8_t lResponse[MODBUS_ADU_MAX_byte];
+
+    return Test_Slave_Request(aRequest, aRequestSize_byte, lResponse, sizeof(lResponse));
+}
+
+// The FC05 write marks the coil
+void Dirty_Coil()
+{
+    // Set coil 3
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_COIL, 0, 3, 0xff, 0x00 };
+
+    uint16_t lAddress;
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sCoilRanges + 0, &lAddress));
+
+    TEST_CHECK(8 == Request(REQUEST, sizeof(REQUEST)));
+
+    TEST_CHECK(Modbus_Slave_NextDirty(sCoilRanges + 0, &lAddress));
+    TEST_CHECK(3 == lAddress);
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sCoilRanges + 0, &lAddress));
+    TEST_CHECK(0 == sCoilBits[0]);
+}
+
+// The written registers are returned once, in address order. A complete
+// iteration clears all the marks.
+void Dirty_Iterate()
+{
+    // Write register 105
+    static const uint8_t SINGLE[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 105, 0x12, 0x34 };
+
+    // Write registers 130 to 132, the marks use 2 words
+    static const uint8_t MULTIPLE[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 130, 0, 3, 6, 0, 1, 0, 2, 0, 3 };
+
+    static const uint16_t EXPECTED[] = { 105, 130, 131, 132 };
+
+    uint16_t lAddress;
+
+    unsigned int i;
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+
+    TEST_CHECK(8 == Request(MULTIPLE, sizeof(MULTIPLE)));
+    TEST_CHECK(8 == Request(SINGLE  , sizeof(SINGLE  )));
+
+    for (i = 0; i < sizeof(EXPECTED) / sizeof(EXPECTED[0]); i++)
+    {
+        TEST_CHECK(Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+        TEST_CHECK(EXPECTED[i] == lAddress);
+    }
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+
+    TEST_CHECK((0 == sRegisterBits[0]) && (0 == sRegisterBits[1]) && (0 == sRegisterBits[2]));
+
+    // The next iteration only returns the new writes
+    TEST_CHECK(8 == Request(SINGLE, sizeof(SINGLE)));
+
+    TEST_CHECK(Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+    TEST_CHECK(105 == lAddress);
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+}
+
+// A write below the current position of an iteration is returned by the
+// same iteration
+void Dirty_Lower()
+{
+    // Write registers 110 and 111
+    static const uint8_t MULTIPLE[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 110, 0, 2, 4, 0, 1, 0, 2 };
+
+    // Write register 102
+    static const uint8_t SINGLE[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 102, 0x56, 0x78 };
+
+    uint16_t lAddress;
+
+    TEST_CHECK(8 == Request(MULTIPLE, sizeof(MULTIPLE)));
+
+    TEST_CHECK(Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+    TEST_CHECK(110 == lAddress);
+
+    TEST_CHECK(8 == Request(SINGLE, sizeof(SINGLE)));
+
+    TEST_CHECK(Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+    TEST_CHECK(102 == lAddress);
+
+    TEST_CHECK(Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+    TEST_CHECK(111 == lAddress);
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sRanges + 0, &lAddress));
+}
+
+// A write mBeforeWrite rejects does not mark the register
+void Dirty_Rejected()
+{
+    // Write register 200
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 200, 0x9a, 0xbc };
+
+    uint16_t lAddress;
+
+    TEST_CHECK(5 == Request(REQUEST, sizeof(REQUEST)));
+
+    TEST_CHECK(!Modbus_Slave_NextDirty(sRanges + 1, &lAddress));
+    TEST_CHECK(0 == sReadOnly[0]);
+}
@@ -0,0 +1,196 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_EEPROM.c
+
+// Registers and records stored in an EEPROM, see Modbus_Slave_EEPROM.h.
+// This file replaces EEPROM.c. The read and write operations last
+// PENDING_QTY calls of EEPROM_Status, the read operations fill the output
+// half at the start and half at the end.
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave_EEPROM.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define PENDING_QTY (3)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static EEPROM sEEPROM;
+
+static const uint8_t* sIn; // End of the read data, copied at the completion
+static uint8_t        sMemory[256];
+static uint8_t*       sOut;
+static uint16_t       sOutSize_byte;
+static unsigned int   sPending; // EEPROM_Status calls before the completion
+static uint8_t        sResult = EEPROM_SUCCESS;
+
+static Modbus_Slave_EEPROM sBinding = { &sEEPROM, 0x40, 0 };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { &sBinding, 100, 8, NULL, Modbus_Slave_Callback_EEPROM_Read, Modbus_Slave_Callback_EEPROM_Write, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static const Modbus_Slave_File sFiles[1] = { { 1, sRanges, 1 } };
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Error      ();
+static void Read       ();
+static void ReadRecords();
+static void Write      ();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitFiles(sFiles, 1);
+
+    Test_Slave_Run(10);
+
+    Read       ();
+    ReadRecords();
+    Write      ();
+    Error      ();
+
+    return Test_Result("Test_EEPROM");
+}
+
+// Functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t EEPROM_Idle(EEPROM* aThis)
+{
+    return 0 == sPending;
+}
+
+void EEPROM_Read(EEPROM* aThis, uint8_t aAddress, void* aOut, uint16_t aOutSize_byte)
+{
+    uint16_t lHalf_byte = aOutSize_byte / 2;
+
+    memcpy(aOut, sMemory + aAddress, lHalf_byte);
+
+    sIn           = sMemory + aAddress + lHalf_byte;
+    sOut          = (uint8_t*)aOut + lHalf_byte;
+    sOutSize_byte = aOutSize_byte - lHalf_byte;
+    sPending      = PENDING_QTY;
+}
+
+uint8_t EEPROM_Status(EEPROM* aThis)
+{
+    if (0 < sPending)
+    {
+        sPending--;
+
+        if (0 < sPending)
+        {
+            return EEPROM_PENDING;
+        }
+
+        if (NULL != sOut)
+        {
+            memcpy(sOut, sIn, sOutSize_byte);
+
+            sOut = NULL;
+        }
+    }
+
+    return sResult;
+}
+
+void EEPROM_Write(EEPROM* aThis, uint8_t aAddress, const void* aIn, uint16_t aInSize_byte)
+{
+    memcpy(sMemory + aAddress, aIn, aInSize_byte);
+
+    sPending = PENDING_QTY;
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// The EEPROM fails, the slave responds with an exception
+void Error()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 100, 0, 1 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    sResult = EEPROM_ERROR;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, MODBUS_EXCEPTION_SERVER_DEVICE_FAILURE);
+
+    sResult = EEPROM_SUCCESS;
+}
+
+void Read()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 101, 0, 3 };
+
+    static const uint8_t RESPONSE[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 6, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    // Register 101 is at 0x42, the most significant byte first
+    memcpy(sMemory + 0x42, RESPONSE + 3, 6);
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(0 == memcmp(RESPONSE, lResponse, sizeof(RESPONSE)));
+}
+
+void ReadRecords()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 7, 6, 0, 1, 0, 106, 0, 2 };
+
+    static const uint8_t RESPONSE[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 6, 5, 6, 0xfe, 0xdc, 0xba, 0x98 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    memcpy(sMemory + 0x4c, RESPONSE + 5, 4);
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(0 == memcmp(RESPONSE, lResponse, sizeof(RESPONSE)));
+}
+
+void Write()
+{
+    static const uint8_t WRITE[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 104, 0, 2, 4, 0x11, 0x22, 0x33, 0x44 };
+    static const uint8_t READ [] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 104, 0, 2 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(WRITE, sizeof(WRITE), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK(0 == memcmp(WRITE, lResponse, 6));
+    TEST_CHECK(0 == memcmp(WRITE + 7, sMemory + 0x48, 4));
+
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    TEST_CHECK(9 == lSize_byte);
+    TEST_CHECK(0 == memcmp(WRITE + 7, lResponse + 3, 4));
+}
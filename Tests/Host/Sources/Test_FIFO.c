@@ -0,0 +1,127 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_FIFO.c
+
+// Read FIFO Queue (FC24)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sQueue[40];
+static uint16_t sRegisters[1];
+
+static Modbus_Slave_FIFO sFIFOs[1] = { { 0x0100, sQueue, 40, 0, 0, 0 } };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aFirst  The value expected first
+// aCount  The number of values expected
+static void Check_Read(uint16_t aFirst, uint16_t aCount);
+
+static void Full();
+static void Read();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    static const uint8_t UNKNOWN[] = { 1, MODBUS_FUNCTION_READ_FIFO_QUEUE, 0x01, 0x01 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitFIFOs(sFIFOs, 1);
+
+    Test_Slave_Run(10);
+
+    Read();
+    Full();
+
+    lSize_byte = Test_Slave_Request(UNKNOWN, sizeof(UNKNOWN), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_FIFO_QUEUE, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    return Test_Result("Test_FIFO");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Check_Read(uint16_t aFirst, uint16_t aCount)
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_FIFO_QUEUE, 0x01, 0x00 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    uint16_t i;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(1 + 1 + 2 + 2 + 2 * aCount + 2 == lSize_byte);
+    TEST_CHECK((8 <= lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK((0 == lResponse[2]) && (2 + 2 * aCount == lResponse[3]));
+    TEST_CHECK((0 == lResponse[4]) && (aCount == lResponse[5]));
+
+    for (i = 0; i < aCount; i++)
+    {
+        uint16_t lValue = aFirst + i;
+
+        TEST_CHECK(((uint8_t)(lValue >> 8) == lResponse[6 + 2 * i]) && ((uint8_t)lValue == lResponse[7 + 2 * i]));
+    }
+}
+
+void Full()
+{
+    uint16_t i;
+
+    // The FIFO holds 39 values
+    for (i = 0; i < 39; i++)
+    {
+        TEST_CHECK(Modbus_Slave_FIFO_Push(sFIFOs, 0x2000 + i));
+    }
+
+    TEST_CHECK(!Modbus_Slave_FIFO_Push(sFIFOs, 0x3000));
+    TEST_CHECK(1 == sFIFOs[0].mOverflows);
+
+    Check_Read(0x2000, MODBUS_FIFO_COUNT_MAX);
+    Check_Read(0x2000 + MODBUS_FIFO_COUNT_MAX, 39 - MODBUS_FIFO_COUNT_MAX);
+}
+
+void Read()
+{
+    uint16_t i;
+
+    Check_Read(0, 0);
+
+    // A request returns up to 31 values, oldest first
+    for (i = 0; i < 35; i++)
+    {
+        TEST_CHECK(Modbus_Slave_FIFO_Push(sFIFOs, 0x1000 + i));
+    }
+
+    Check_Read(0x1000, MODBUS_FIFO_COUNT_MAX);
+    Check_Read(0x1000 + MODBUS_FIFO_COUNT_MAX, 35 - MODBUS_FIFO_COUNT_MAX);
+    Check_Read(0, 0);
+}
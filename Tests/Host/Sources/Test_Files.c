@@ -0,0 +1,144 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Files.c
+
+// Read File Record (FC20) and Write File Record (FC21)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sHigh[20];
+static uint16_t sLow [130];
+static uint16_t sRegisters[1];
+
+// The second range goes past record 9999, the last valid record number
+static Modbus_Slave_Range sRecords[2] =
+{
+    { NULL,    0, 130, sLow , Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 9990,  20, sHigh, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static const Modbus_Slave_File sFiles[1] = { { 4, sRecords, 2 } };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Limits();
+static void Read();
+static void Write();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitFiles(sFiles, 1);
+
+    Test_Slave_Run(10);
+
+    Read  ();
+    Write ();
+    Limits();
+
+    return Test_Result("Test_Files");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Limits()
+{
+    // The last record, 10000, does not exist
+    static const uint8_t PAST_9999[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 7, 6, 0, 4, 0x27, 0x0f, 0, 2 };
+
+    // 124 records do not fit in the 0xf5 bytes of the response
+    static const uint8_t READ_124[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 7, 6, 0, 4, 0, 0, 0, 124 };
+
+    static const uint8_t UNKNOWN_FILE[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 7, 6, 0, 5, 0, 0, 0, 1 };
+
+    // The byte count is above 0xf5
+    uint8_t  lRequest[3 + 0xf6];
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(PAST_9999, sizeof(PAST_9999), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_FILE_RECORD, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    lSize_byte = Test_Slave_Request(READ_124, sizeof(READ_124), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_FILE_RECORD, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(UNKNOWN_FILE, sizeof(UNKNOWN_FILE), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_FILE_RECORD, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    memset(lRequest, 0, sizeof(lRequest));
+
+    lRequest[0] = 1;
+    lRequest[1] = MODBUS_FUNCTION_WRITE_FILE_RECORD;
+    lRequest[2] = 0xf6;
+    lRequest[3] = 6;
+    lRequest[5] = 4;
+    lRequest[8] = 119;
+
+    lSize_byte = Test_Slave_Request(lRequest, sizeof(lRequest), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_FILE_RECORD, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+}
+
+void Read()
+{
+    // Records 1 and 2, then records 9998 and 9999
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 14, 6, 0, 4, 0, 1, 0, 2, 6, 0, 4, 0x27, 0x0e, 0, 2 };
+
+    static const uint8_t RESPONSE[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 12, 5, 6, 0x11, 0x11, 0x22, 0x22, 5, 6, 0x99, 0x98, 0x99, 0x99 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    sLow [1] = 0x1111;
+    sLow [2] = 0x2222;
+    sHigh[8] = 0x9998;
+    sHigh[9] = 0x9999;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(0 == memcmp(RESPONSE, lResponse, sizeof(RESPONSE)));
+}
+
+void Write()
+{
+    // Records 3 and 4, then record 9999
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_FILE_RECORD, 20, 6, 0, 4, 0, 3, 0, 2, 0x12, 0x34, 0x56, 0x78, 6, 0, 4, 0x27, 0x0f, 0, 1, 0xab, 0xcd };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    // The response is a copy of the request
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(REQUEST) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(0 == memcmp(REQUEST, lResponse, sizeof(REQUEST)));
+
+    TEST_CHECK((0x1234 == sLow[3]) && (0x5678 == sLow[4]));
+    TEST_CHECK(0xabcd == sHigh[9]);
+}
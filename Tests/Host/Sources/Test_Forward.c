@@ -0,0 +1,183 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Forward.c
+
+// Gateway forwarding the requests for devices 10 to 19 through a
+// Modbus_Master instance using UART 1
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Master.h"
+#include "Modbus_Slave.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define DOWNSTREAM_UART (1)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static Modbus_Master sMaster;
+
+static uint16_t sRegisters[4];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static const Modbus_Slave_Route ROUTES[1] = { { &sMaster, Modbus_Master_Forward, 10, 19 } };
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Init();
+
+// aResponse  The downstream response, without its CRC. NULL, the
+//            downstream device does not respond.
+//
+// Return  The size of the upstream response
+static uint16_t Run(const uint8_t* aRequest, uint16_t aRequestSize_byte, const uint8_t* aResponse, uint16_t aResponseSize_byte, uint8_t* aOut);
+
+static void Forward_Read   ();
+static void Forward_Timeout();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Forward_Read   ();
+    Forward_Timeout();
+
+    return Test_Result("Test_Forward");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Init()
+{
+    GPIO lOutputEnable;
+
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitGateway(ROUTES, 1);
+
+    memset(&lOutputEnable, 0, sizeof(lOutputEnable));
+
+    lOutputEnable.mBit  = 4;
+    lOutputEnable.mPort = GPIO_PORT_C;
+
+    memset(&sMaster, 0, sizeof(sMaster));
+
+    Modbus_Master_Init(&sMaster, DOWNSTREAM_UART, NULL, 0, lOutputEnable);
+    Modbus_Master_InitRetry(&sMaster, 20, 0);
+
+    Test_Slave_Run(10);
+}
+
+uint16_t Run(const uint8_t* aRequest, uint16_t aRequestSize_byte, const uint8_t* aResponse, uint16_t aResponseSize_byte, uint8_t* aOut)
+{
+    uint8_t  lFrame[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+    unsigned int j;
+
+    memcpy(lFrame, aRequest, aRequestSize_byte);
+    Modbus_CRC_Compute_Buffer(lFrame, aRequestSize_byte);
+
+    Stub_Receive(TEST_UART, lFrame, aRequestSize_byte + sizeof(uint16_t), 5000);
+
+    for (i = 0; i < 100; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            Stub_Wait(250);
+
+            Modbus_Slave_Work();
+            Modbus_Master_Work(&sMaster);
+
+            // The downstream device receives the request as is
+            lSize_byte = Stub_Sent(DOWNSTREAM_UART, lFrame, sizeof(lFrame));
+            if (0 < lSize_byte)
+            {
+                TEST_CHECK(aRequestSize_byte + sizeof(uint16_t) == lSize_byte);
+                TEST_CHECK(0 == memcmp(aRequest, lFrame, aRequestSize_byte));
+                TEST_CHECK(Modbus_CRC_Verify_Buffer(lFrame, lSize_byte));
+
+                if (NULL != aResponse)
+                {
+                    memcpy(lFrame, aResponse, aResponseSize_byte);
+                    Modbus_CRC_Compute_Buffer(lFrame, aResponseSize_byte);
+
+                    Stub_Wait(3000);
+                    Stub_Receive(DOWNSTREAM_UART, lFrame, aResponseSize_byte + sizeof(uint16_t), 2000);
+                }
+            }
+        }
+
+        Modbus_Slave_Tick(1);
+        Modbus_Master_Tick(&sMaster, 1);
+    }
+
+    return Stub_Sent(TEST_UART, aOut, MODBUS_ADU_MAX_byte);
+}
+
+void Forward_Read()
+{
+    static const uint8_t REQUEST [] = { 12, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 4 };
+    static const uint8_t RESPONSE[] = { 12, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 8, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lOut[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    Init();
+
+    // The response is longer than the request, the request CRC must not
+    // overwrite it while the forward function is pending.
+    lSize_byte = Run(REQUEST, sizeof(REQUEST), RESPONSE, sizeof(RESPONSE), lOut);
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(0 == memcmp(RESPONSE, lOut, sizeof(RESPONSE)));
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lOut, lSize_byte));
+
+    // Twice, the forward function is ready for the next request
+    lSize_byte = Run(REQUEST, sizeof(REQUEST), RESPONSE, sizeof(RESPONSE), lOut);
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(0 == memcmp(RESPONSE, lOut, sizeof(RESPONSE)));
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(2 == lCounters.mBusMessages);
+    TEST_CHECK(0 == lCounters.mBusCommErrors);
+}
+
+void Forward_Timeout()
+{
+    static const uint8_t REQUEST[] = { 15, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 1, 0x12, 0x34 };
+
+    uint8_t  lOut[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    Init();
+
+    lSize_byte = Run(REQUEST, sizeof(REQUEST), NULL, 0, lOut);
+    TEST_CHECK(5 == lSize_byte);
+    TEST_CHECK(15 == lOut[MODBUS_BYTE_DEVICE]);
+    TEST_CHECK((MODBUS_FUNCTION_WRITE_SINGLE_REGISTER | MODBUS_FUNCTION_ERROR) == lOut[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK(MODBUS_EXCEPTION_GATEWAY_TARGET_DEVICE_FAILED_TO_RESPOND == lOut[MODBUS_BYTE_EXCEPTION]);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lOut, lSize_byte));
+}
@@ -0,0 +1,253 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Framing.c
+
+// RTU framing of the requests, received through the UART stream mode
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+#include "UART.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int sPendingCalls;
+
+static uint16_t sRegisters[4] = { 0x1234, 0x5678, 0x9abc, 0xdef0 };
+static uint16_t sSlow     [2];
+
+static uint8_t Slow_AfterWrite(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+static Modbus_Slave_Range sRanges[2] =
+{
+    { NULL,  0, 4, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 10, 2, sSlow     , Modbus_Slave_Callback_Default, Slow_AfterWrite              , Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static const uint8_t READ [] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 2 };
+static const uint8_t WRITE[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 10, 0xab, 0xcd };
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Check_Read(const uint8_t* aResponse, uint16_t aSize_byte);
+
+static uint16_t Seal(const uint8_t* aIn, uint16_t aInSize_byte, uint8_t* aOut);
+
+static void BackToBack  (uint8_t aFast);
+static void Gap         (uint8_t aFast);
+static void Pending     ();
+static void ReceiveError();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    BackToBack(0);
+    BackToBack(1);
+    Gap       (0);
+    Gap       (1);
+
+    Pending     ();
+    ReceiveError();
+
+    return Test_Result("Test_Framing");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint8_t Slow_AfterWrite(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    sPendingCalls++;
+
+    return (400 > sPendingCalls) ? MODBUS_SLAVE_PENDING : MODBUS_NO_ERROR;
+}
+
+void Check_Read(const uint8_t* aResponse, uint16_t aSize_byte)
+{
+    TEST_CHECK(9 == aSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(aResponse, aSize_byte));
+    TEST_CHECK((0x56 == aResponse[3]) && (0x78 == aResponse[4]) && (0x9a == aResponse[5]) && (0xbc == aResponse[6]));
+}
+
+uint16_t Seal(const uint8_t* aIn, uint16_t aInSize_byte, uint8_t* aOut)
+{
+    memcpy(aOut, aIn, aInSize_byte);
+
+    Modbus_CRC_Compute_Buffer(aOut, aInSize_byte);
+
+    return aInSize_byte + sizeof(uint16_t);
+}
+
+void BackToBack(uint8_t aFast)
+{
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    Test_Slave_Init(sRanges, 2);
+
+    if (aFast)
+    {
+        Modbus_Slave_InitFastRead();
+    }
+
+    Test_Slave_Run(10);
+
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    Check_Read(lResponse, lSize_byte);
+
+    // The next request starts 3.5 characters after the end of the
+    // response, before Modbus_Slave_Work is called.
+    lSize_byte = Seal(READ, sizeof(READ), lFrame);
+
+    Stub_Receive(TEST_UART, lFrame, lSize_byte, 5000);
+    Stub_Wait(5 * UART_CharTime_us(TEST_UART));
+    Test_Slave_Run(1);
+    TEST_CHECK(9 == Stub_Sent(TEST_UART, lResponse, sizeof(lResponse)));
+    Stub_Wait(10000); // The response is sent
+    Stub_Receive(TEST_UART, lFrame, lSize_byte, 2000);
+    Test_Slave_Run(10);
+
+    lSize_byte = Stub_Sent(TEST_UART, lResponse, sizeof(lResponse));
+    Check_Read(lResponse, lSize_byte);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(3 == lCounters.mBusMessages);
+    TEST_CHECK(0 == lCounters.mBusCommErrors);
+    TEST_CHECK(3 == lCounters.mServerMessages);
+}
+
+void Gap(uint8_t aFast)
+{
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    Test_Slave_Init(sRanges, 2);
+
+    if (aFast)
+    {
+        Modbus_Slave_InitFastRead();
+    }
+
+    Test_Slave_Run(10);
+
+    // A silence of 2 characters inside the frame makes it invalid
+    lSize_byte = Seal(READ, sizeof(READ), lFrame);
+
+    Stub_Receive(TEST_UART, lFrame    , 3             , 5000);
+    Stub_Receive(TEST_UART, lFrame + 3, lSize_byte - 3, 2 * UART_CharTime_us(TEST_UART));
+    Test_Slave_Run(10);
+    TEST_CHECK(0 == Stub_Sent(TEST_UART, lResponse, sizeof(lResponse)));
+
+    // The next request is processed
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    Check_Read(lResponse, lSize_byte);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(0 < lCounters.mBusCommErrors);
+    TEST_CHECK(1 == lCounters.mServerMessages);
+}
+
+void Pending()
+{
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    unsigned int i;
+
+    Test_Slave_Init(sRanges, 2);
+
+    Modbus_Slave_InitPending(2, MODBUS_EXCEPTION_SERVER_DEVICE_BUSY);
+
+    Test_Slave_Run(10);
+
+    // The callback completes after 400 calls, 100 ms. The slave responds
+    // busy after 2 ms, then completes the write in background.
+    sPendingCalls = 0;
+
+    lSize_byte = Seal(WRITE, sizeof(WRITE), lFrame);
+
+    Stub_Receive(TEST_UART, lFrame, lSize_byte, 5000);
+    Test_Slave_Run(4);
+
+    lSize_byte = Stub_Sent(TEST_UART, lResponse, sizeof(lResponse));
+    TEST_CHECK(5 == lSize_byte);
+    TEST_CHECK(MODBUS_EXCEPTION_SERVER_DEVICE_BUSY == lResponse[MODBUS_BYTE_EXCEPTION]);
+
+    // The frames received before the completion are ignored, and they do
+    // not fill the UART stream.
+    lSize_byte = Seal(READ, sizeof(READ), lFrame);
+
+    for (i = 0; i < 8; i++)
+    {
+        Stub_Receive(TEST_UART, lFrame, lSize_byte, 2000);
+        Test_Slave_Run(1);
+    }
+
+    TEST_CHECK(400 > sPendingCalls);
+    TEST_CHECK(0 == Stub_Sent(TEST_UART, lResponse, sizeof(lResponse)));
+
+    Test_Slave_Run(100);
+    TEST_CHECK(400 == sPendingCalls);
+    TEST_CHECK(0 == Stub_Sent(TEST_UART, lResponse, sizeof(lResponse)));
+
+    lSize_byte = Test_Slave_Request(READ, sizeof(READ), lResponse, sizeof(lResponse));
+    Check_Read(lResponse, lSize_byte);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(2 == lCounters.mServerMessages);
+    TEST_CHECK(1 == lCounters.mServerBusy);
+    TEST_CHECK(0 == lCounters.mOverruns);
+}
+
+void ReceiveError()
+{
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    unsigned int i;
+
+    Test_Slave_Init(sRanges, 2);
+    Test_Slave_Run(10);
+
+    // A byte received with an error makes the frame invalid, even when
+    // its value is right.
+    lSize_byte = Seal(READ, sizeof(READ), lFrame);
+
+    Stub_Wait(5000);
+
+    for (i = 0; i < lSize_byte; i++)
+    {
+        Stub_Wait(UART_CharTime_us(TEST_UART));
+        Stub_Receive_Byte(TEST_UART, lFrame[i], 4 == i);
+    }
+
+    Test_Slave_Run(10);
+    TEST_CHECK(0 == Stub_Sent(TEST_UART, lResponse, sizeof(lResponse)));
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(1 == lCounters.mBusMessages);
+    TEST_CHECK(1 == lCounters.mBusCommErrors);
+}
@@ -0,0 +1,174 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Limits.c
+
+// Register count limits of Read Holding Registers (FC03) and Write
+// Multiple Registers (FC16), with full size RTU frames
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters[200];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 200, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aByteCount  The byte count field, 2 * aCount for a valid request
+//
+// Return  The size of the request, without its CRC
+static uint16_t Write_Build(uint8_t* aOut, uint16_t aCount, uint8_t aByteCount);
+
+static void Read_125  ();
+static void Read_Limit();
+
+static void Write_123  ();
+static void Write_Limit();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Read_125  ();
+    Read_Limit();
+
+    Write_123  ();
+    Write_Limit();
+
+    return Test_Result("Test_Limits");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// Device 0x10 AddrH AddrL CountH CountL ByteCount Data...
+uint16_t Write_Build(uint8_t* aOut, uint16_t aCount, uint8_t aByteCount)
+{
+    unsigned int i;
+
+    aOut[0] = 1;
+    aOut[1] = MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS;
+    aOut[2] = 0;
+    aOut[3] = 0;
+    aOut[4] = (uint8_t)(aCount >> 8);
+    aOut[5] = (uint8_t) aCount;
+    aOut[6] = aByteCount;
+
+    for (i = 0; i < aByteCount; i++)
+    {
+        aOut[7 + i] = (uint8_t)i;
+    }
+
+    return 7 + aByteCount;
+}
+
+void Read_125()
+{
+    // Read registers 10 to 134, the response uses 255 bytes
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 10, 0, 125 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+
+    for (i = 0; i < 200; i++)
+    {
+        sRegisters[i] = 0x1000 + i;
+    }
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(255 == lSize_byte);
+    TEST_CHECK((255 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_READ_HOLDING_REGISTERS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK(250 == lResponse[2]);
+    TEST_CHECK((0x10 == lResponse[3]) && (10 == lResponse[4]));
+    TEST_CHECK((0x10 == lResponse[251]) && (134 == lResponse[252]));
+}
+
+void Read_Limit()
+{
+    static const uint8_t READ_0  [] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0,   0 };
+    static const uint8_t READ_126[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 126 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(READ_0, sizeof(READ_0), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    // The range contains the registers, only the count is invalid
+    lSize_byte = Test_Slave_Request(READ_126, sizeof(READ_126), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+}
+
+void Write_123()
+{
+    uint8_t  lRequest [MODBUS_ADU_MAX_byte];
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    memset(&sRegisters, 0, sizeof(sRegisters));
+
+    // The request uses 255 bytes
+    lSize_byte = Write_Build(lRequest, 123, 246);
+
+    lSize_byte = Test_Slave_Request(lRequest, lSize_byte, lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK((8 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK((0 == lResponse[4]) && (123 == lResponse[5]));
+
+    TEST_CHECK(0x0001 == sRegisters[  0]);
+    TEST_CHECK(0xf4f5 == sRegisters[122]);
+    TEST_CHECK(0x0000 == sRegisters[123]);
+}
+
+void Write_Limit()
+{
+    uint8_t  lRequest [MODBUS_ADU_MAX_byte];
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    memset(&sRegisters, 0, sizeof(sRegisters));
+
+    lSize_byte = Write_Build(lRequest, 0, 0);
+    lSize_byte = Test_Slave_Request(lRequest, lSize_byte, lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    // 124 registers do not fit in a RTU frame, the byte count can only
+    // contain 246 bytes
+    lSize_byte = Write_Build(lRequest, 124, 246);
+    lSize_byte = Test_Slave_Request(lRequest, lSize_byte, lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    // The byte count does not match the register count
+    lSize_byte = Write_Build(lRequest, 2, 2);
+    lSize_byte = Test_Slave_Request(lRequest, lSize_byte, lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    TEST_CHECK((0 == sRegisters[0]) && (0 == sRegisters[123]));
+}
@@ -0,0 +1,68 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Mask.c
+
+// Mask Write Register (FC22)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters[2];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 2, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    // The example of the Modbus specification, And 0x00f2, Or 0x0025
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_MASK_WRITE_REGISTER, 0, 1, 0x00, 0xf2, 0x00, 0x25 };
+
+    static const uint8_t OUTSIDE[] = { 1, MODBUS_FUNCTION_MASK_WRITE_REGISTER, 0, 2, 0x00, 0xf2, 0x00, 0x25 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    sRegisters[1] = 0x0012;
+
+    // The response is an echo of the request
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(sizeof(REQUEST) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+
+    for (i = 0; i < sizeof(REQUEST); i++)
+    {
+        TEST_CHECK(REQUEST[i] == lResponse[i]);
+    }
+
+    TEST_CHECK(0x0017 == sRegisters[1]);
+    TEST_CHECK(0x0000 == sRegisters[0]);
+
+    lSize_byte = Test_Slave_Request(OUTSIDE, sizeof(OUTSIDE), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_MASK_WRITE_REGISTER, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    return Test_Result("Test_Mask");
+}
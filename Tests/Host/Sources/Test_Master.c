@@ -0,0 +1,480 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Master.c
+
+// Scheduling of the Modbus_Master requests. The test plays the slaves on
+// UART 0. Device 1 responds, device 2 does not.
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Master.h"
+#include "Modbus_Slave.h"
+#include "UART.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define ABSENT_DEVICE  (2)
+#define PRESENT_DEVICE (1)
+
+#define COMPLETED_QTY (8)
+#define SENT_QTY      (32)
+
+#define TIMEOUT_ms (20)
+
+// Data types
+// //////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+    uint16_t mAddress;
+    uint32_t mTime_ms;
+}
+Sent;
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t     sBackOff_ms[COMPLETED_QTY];
+static unsigned int sCompleted;
+
+static Modbus_Master sMaster;
+
+static uint32_t sNow_ms;
+
+static Sent         sSent[SENT_QTY];
+static unsigned int sSentCount;
+
+static uint8_t sStall;
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Init(Modbus_Master_Request* aRequests, uint8_t aRequestQty, uint8_t aRetryMax);
+
+// Record the back-off delay following the completion
+static void OnCompleted(struct Modbus_Master_Request_s* aRequest);
+
+// Record the request the master sent and respond to it
+static void Respond();
+
+// Call Modbus_Master_Work every 250 us and Modbus_Master_Tick every ms
+static void Run(uint32_t aDuration_ms);
+
+// Run until the count of completed requests reaches aCompleted
+static void Run_Until(unsigned int aCompleted);
+
+static void Master_BackOff   ();
+static void Master_Period    ();
+static void Master_Priority  ();
+static void Master_Retry     ();
+static void Master_Submit    ();
+static void Master_WriteError();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Master_BackOff   ();
+    Master_Period    ();
+    Master_Priority  ();
+    Master_Retry     ();
+    Master_Submit    ();
+    Master_WriteError();
+
+    return Test_Result("Test_Master");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Init(Modbus_Master_Request* aRequests, uint8_t aRequestQty, uint8_t aRetryMax)
+{
+    GPIO lOutputEnable;
+
+    Stub_Init();
+
+    memset(&lOutputEnable, 0, sizeof(lOutputEnable));
+
+    lOutputEnable.mBit  = 4;
+    lOutputEnable.mPort = GPIO_PORT_C;
+
+    Modbus_Master_Init     (&sMaster, TEST_UART, aRequests, aRequestQty, lOutputEnable);
+    Modbus_Master_InitRetry(&sMaster, TIMEOUT_ms, aRetryMax);
+
+    sCompleted = 0;
+    sNow_ms    = 0;
+    sSentCount = 0;
+    sStall     = 0;
+}
+
+void OnCompleted(struct Modbus_Master_Request_s* aRequest)
+{
+    if (COMPLETED_QTY > sCompleted)
+    {
+        sBackOff_ms[sCompleted] = aRequest->mBackOff_ms;
+    }
+
+    sCompleted++;
+}
+
+// Device Function Address Count|Value CRC
+void Respond()
+{
+    uint16_t lAddress;
+    uint8_t  lFrame[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    unsigned int i;
+
+    lSize_byte = Stub_Sent(TEST_UART, lFrame, sizeof(lFrame));
+    if (0 == lSize_byte)
+    {
+        return;
+    }
+
+    TEST_CHECK((8 <= lSize_byte) && Modbus_CRC_Verify_Buffer(lFrame, lSize_byte));
+
+    lAddress = ((uint16_t)lFrame[2] << 8) | lFrame[3];
+
+    if (SENT_QTY > sSentCount)
+    {
+        sSent[sSentCount].mAddress = lAddress;
+        sSent[sSentCount].mTime_ms = sNow_ms;
+    }
+
+    sSentCount++;
+
+    // The request leaves the transmitter, unless the test stalls it
+    Stub_Wait((uint32_t)UART_CharTime_us(TEST_UART) * lSize_byte);
+
+    if ((PRESENT_DEVICE != lFrame[MODBUS_BYTE_DEVICE]) || sStall)
+    {
+        return;
+    }
+
+    switch (lFrame[MODBUS_BYTE_FUNCTION])
+    {
+    case MODBUS_FUNCTION_READ_HOLDING_REGISTERS:
+        // Device Function ByteCount Data... CRC, register n contains n
+        lFrame[2]  = 2 * lFrame[5];
+        lSize_byte = 3 + lFrame[2];
+
+        for (i = 0; i < lFrame[2] / 2; i++)
+        {
+            lFrame[3 + 2 * i] = (uint8_t)((lAddress + i) >> 8);
+            lFrame[4 + 2 * i] = (uint8_t) (lAddress + i);
+        }
+        break;
+
+    case MODBUS_FUNCTION_WRITE_SINGLE_REGISTER: lSize_byte = 6; break;
+
+    default: TEST_CHECK(0);
+    }
+
+    Modbus_CRC_Compute_Buffer(lFrame, lSize_byte);
+
+    Stub_Receive(TEST_UART, lFrame, lSize_byte + sizeof(uint16_t), 1000);
+}
+
+void Run(uint32_t aDuration_ms)
+{
+    uint32_t     i;
+    unsigned int j;
+
+    for (i = 0; i < aDuration_ms; i++)
+    {
+        for (j = 0; j < 4; j++)
+        {
+            Stub_Wait(250);
+
+            Modbus_Master_Work(&sMaster);
+
+            Respond();
+        }
+
+        Modbus_Master_Tick(&sMaster, 1);
+
+        sNow_ms++;
+    }
+}
+
+void Run_Until(unsigned int aCompleted)
+{
+    uint32_t lLimit_ms = sNow_ms + 10000;
+
+    while ((aCompleted > sCompleted) && (lLimit_ms > sNow_ms))
+    {
+        Run(1);
+    }
+
+    TEST_CHECK(aCompleted == sCompleted);
+}
+
+// The back-off delay of a failing poll request doubles up to 1 s and
+// returns to 0 after a success
+void Master_BackOff()
+{
+    static const uint16_t EXPECTED_ms[COMPLETED_QTY] = { 100, 200, 400, 800, 1000, 1000 };
+
+    uint16_t              lData[1];
+    Modbus_Master_Request lRequests[1];
+
+    unsigned int i;
+
+    memset(&lRequests, 0, sizeof(lRequests));
+
+    lRequests[0].mAddress     = 10;
+    lRequests[0].mCount       = 1;
+    lRequests[0].mData        = lData;
+    lRequests[0].mDevice      = ABSENT_DEVICE;
+    lRequests[0].mFunction    = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+    lRequests[0].mOnCompleted = OnCompleted;
+    lRequests[0].mPeriod_ms   = 10;
+
+    Init(lRequests, 1, 0);
+
+    Run_Until(6);
+
+    TEST_CHECK(6 == sSentCount);
+
+    for (i = 0; i < 6; i++)
+    {
+        TEST_CHECK(EXPECTED_ms[i] == sBackOff_ms[i]);
+    }
+
+    // The request waits for its period and its back-off delay
+    for (i = 1; i < 6; i++)
+    {
+        TEST_CHECK(10 + EXPECTED_ms[i - 1] <= sSent[i].mTime_ms - sSent[i - 1].mTime_ms);
+    }
+
+    lRequests[0].mDevice = PRESENT_DEVICE;
+
+    Run_Until(7);
+
+    TEST_CHECK(MODBUS_NO_ERROR == lRequests[0].mResult);
+    TEST_CHECK(0 == sBackOff_ms[6]);
+    TEST_CHECK(10 == lData[0]);
+}
+
+// A poll request goes out every mPeriod_ms after its completion
+void Master_Period()
+{
+    uint16_t              lData[2];
+    Modbus_Master_Request lRequests[1];
+
+    unsigned int i;
+
+    memset(&lRequests, 0, sizeof(lRequests));
+
+    lRequests[0].mAddress     = 10;
+    lRequests[0].mCount       = 2;
+    lRequests[0].mData        = lData;
+    lRequests[0].mDevice      = PRESENT_DEVICE;
+    lRequests[0].mFunction    = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+    lRequests[0].mOnCompleted = OnCompleted;
+    lRequests[0].mPeriod_ms   = 50;
+
+    Init(lRequests, 1, 2);
+
+    Run(500);
+
+    TEST_CHECK((8 <= sSentCount) && (10 >= sSentCount));
+    TEST_CHECK(sSentCount == sCompleted);
+    TEST_CHECK(MODBUS_NO_ERROR == lRequests[0].mResult);
+    TEST_CHECK((10 == lData[0]) && (11 == lData[1]));
+
+    for (i = 1; i < sSentCount; i++)
+    {
+        uint32_t lInterval_ms = sSent[i].mTime_ms - sSent[i - 1].mTime_ms;
+
+        TEST_CHECK((50 <= lInterval_ms) && (50 + TIMEOUT_ms > lInterval_ms));
+    }
+}
+
+// When many poll requests are due, the lowest mPriority goes first
+void Master_Priority()
+{
+    uint16_t              lData[3];
+    Modbus_Master_Request lRequests[3];
+
+    memset(&lRequests, 0, sizeof(lRequests));
+
+    lRequests[0].mAddress   = 10;
+    lRequests[0].mPriority  = 2;
+    lRequests[1].mAddress   = 20;
+    lRequests[1].mPriority  = 0;
+    lRequests[2].mAddress   = 30;
+    lRequests[2].mPriority  = 1;
+
+    lRequests[0].mData = lData + 0;
+    lRequests[1].mData = lData + 1;
+    lRequests[2].mData = lData + 2;
+
+    lRequests[0].mCount = lRequests[1].mCount = lRequests[2].mCount = 1;
+
+    lRequests[0].mDevice = lRequests[1].mDevice = lRequests[2].mDevice = PRESENT_DEVICE;
+
+    lRequests[0].mFunction = lRequests[1].mFunction = lRequests[2].mFunction = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+
+    lRequests[0].mPeriod_ms = lRequests[1].mPeriod_ms = lRequests[2].mPeriod_ms = 1000;
+
+    Init(lRequests, 3, 2);
+
+    Run(100);
+
+    TEST_CHECK(3 == sSentCount);
+    TEST_CHECK(20 == sSent[0].mAddress);
+    TEST_CHECK(30 == sSent[1].mAddress);
+    TEST_CHECK(10 == sSent[2].mAddress);
+
+    TEST_CHECK((10 == lData[0]) && (20 == lData[1]) && (30 == lData[2]));
+}
+
+// A request to an absent device goes out 1 + aRetryMax times, each attempt
+// waits for the response timeout
+void Master_Retry()
+{
+    uint16_t              lData[1];
+    Modbus_Master_Request lRequest;
+
+    unsigned int i;
+
+    memset(&lRequest, 0, sizeof(lRequest));
+
+    lRequest.mAddress     = 10;
+    lRequest.mCount       = 1;
+    lRequest.mData        = lData;
+    lRequest.mDevice      = ABSENT_DEVICE;
+    lRequest.mFunction    = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+    lRequest.mOnCompleted = OnCompleted;
+
+    Init(NULL, 0, 2);
+
+    Run(10);
+
+    Modbus_Master_Submit(&sMaster, &lRequest);
+
+    TEST_CHECK(MODBUS_MASTER_PENDING == lRequest.mResult);
+
+    Run(200);
+
+    TEST_CHECK(3 == sSentCount);
+    TEST_CHECK(1 == sCompleted);
+    TEST_CHECK(MODBUS_MASTER_TIMEOUT == lRequest.mResult);
+
+    for (i = 1; i < 3; i++)
+    {
+        TEST_CHECK(TIMEOUT_ms <= sSent[i].mTime_ms - sSent[i - 1].mTime_ms);
+    }
+
+    // A submitted request does not use the back-off delay
+    TEST_CHECK(0 == sBackOff_ms[0]);
+}
+
+// The submitted requests go out in order, before the due poll requests
+void Master_Submit()
+{
+    uint16_t              lData[3];
+    Modbus_Master_Request lRequests[1];
+    Modbus_Master_Request lSubmitted[2];
+
+    memset(&lRequests , 0, sizeof(lRequests ));
+    memset(&lSubmitted, 0, sizeof(lSubmitted));
+
+    lRequests[0].mAddress   = 10;
+    lRequests[0].mCount     = 1;
+    lRequests[0].mData      = lData + 0;
+    lRequests[0].mDevice    = PRESENT_DEVICE;
+    lRequests[0].mFunction  = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+    lRequests[0].mPeriod_ms = 1000;
+
+    lSubmitted[0].mAddress  = 30;
+    lSubmitted[0].mCount    = 1;
+    lSubmitted[0].mData     = lData + 1;
+    lSubmitted[0].mDevice   = PRESENT_DEVICE;
+    lSubmitted[0].mFunction = MODBUS_FUNCTION_WRITE_SINGLE_REGISTER;
+
+    lSubmitted[1].mAddress  = 20;
+    lSubmitted[1].mCount    = 1;
+    lSubmitted[1].mData     = lData + 2;
+    lSubmitted[1].mDevice   = PRESENT_DEVICE;
+    lSubmitted[1].mFunction = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+
+    lData[1] = 0x1234;
+
+    Init(lRequests, 1, 2);
+
+    Modbus_Master_Submit(&sMaster, lSubmitted + 0);
+    Modbus_Master_Submit(&sMaster, lSubmitted + 1);
+
+    Run(100);
+
+    TEST_CHECK(3 == sSentCount);
+    TEST_CHECK(30 == sSent[0].mAddress);
+    TEST_CHECK(20 == sSent[1].mAddress);
+    TEST_CHECK(10 == sSent[2].mAddress);
+
+    TEST_CHECK(MODBUS_NO_ERROR == lSubmitted[0].mResult);
+    TEST_CHECK(MODBUS_NO_ERROR == lSubmitted[1].mResult);
+    TEST_CHECK(MODBUS_NO_ERROR == lRequests [0].mResult);
+    TEST_CHECK((10 == lData[0]) && (20 == lData[2]));
+}
+
+// A write that does not end counts as a retry. The request completes with
+// MODBUS_MASTER_TIMEOUT after the last one and the next request goes out.
+void Master_WriteError()
+{
+    uint16_t              lData[2];
+    Modbus_Master_Request lRequests[2];
+
+    memset(&lRequests, 0, sizeof(lRequests));
+
+    lRequests[0].mAddress     = 10;
+    lRequests[1].mAddress     = 20;
+    lRequests[0].mData        = lData + 0;
+    lRequests[1].mData        = lData + 1;
+    lRequests[0].mOnCompleted = lRequests[1].mOnCompleted = OnCompleted;
+
+    lRequests[0].mCount    = lRequests[1].mCount    = 1;
+    lRequests[0].mDevice   = lRequests[1].mDevice   = PRESENT_DEVICE;
+    lRequests[0].mFunction = lRequests[1].mFunction = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+
+    Init(NULL, 0, 2);
+
+    Run(10);
+
+    sStall = 1;
+    Stub_Stall(TEST_UART, sStall);
+
+    Modbus_Master_Submit(&sMaster, lRequests + 0);
+    Modbus_Master_Submit(&sMaster, lRequests + 1);
+
+    Run_Until(1);
+
+    TEST_CHECK(3 == sSentCount);
+    TEST_CHECK(MODBUS_MASTER_TIMEOUT == lRequests[0].mResult);
+    TEST_CHECK(MODBUS_MASTER_PENDING == lRequests[1].mResult);
+
+    sStall = 0;
+    Stub_Stall(TEST_UART, sStall);
+
+    Run_Until(2);
+
+    TEST_CHECK(MODBUS_NO_ERROR == lRequests[1].mResult);
+    TEST_CHECK(20 == lData[1]);
+}
@@ -0,0 +1,169 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_OutputEnable.c
+
+// Release of the RS-485 output enable by the transmit complete callback,
+// without waiting for Modbus_Slave_Work or Modbus_Master_Work. The slave
+// uses UART 0, the master UART 1.
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Master.h"
+#include "Modbus_Slave.h"
+#include "UART.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define MASTER_UART (1)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static GPIO sMasterOutputEnable;
+static GPIO sSlaveOutputEnable;
+
+static uint16_t sRegisters[1] = { 0x1234 };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void OutputEnable_Master();
+static void OutputEnable_Slave ();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    memset(&sMasterOutputEnable, 0, sizeof(sMasterOutputEnable));
+    memset(&sSlaveOutputEnable , 0, sizeof(sSlaveOutputEnable ));
+
+    sMasterOutputEnable.mBit  = 4;
+    sMasterOutputEnable.mPort = GPIO_PORT_C;
+    sSlaveOutputEnable .mBit  = 3;
+    sSlaveOutputEnable .mPort = GPIO_PORT_C;
+
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    OutputEnable_Slave ();
+    OutputEnable_Master();
+
+    return Test_Result("Test_OutputEnable");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// The read starts from the callback too, a response received before the
+// next Modbus_Master_Work is not lost
+void OutputEnable_Master()
+{
+    // Register 0 contains 0x5678
+    uint8_t lResponse[7] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 2, 0x56, 0x78 };
+
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    Modbus_Master         lMaster;
+    Modbus_Master_Request lRequest;
+    uint16_t              lData;
+    uint16_t              lSize_byte;
+
+    unsigned int i;
+
+    memset(&lMaster , 0, sizeof(lMaster ));
+    memset(&lRequest, 0, sizeof(lRequest));
+
+    lRequest.mCount    = 1;
+    lRequest.mData     = &lData;
+    lRequest.mDevice   = 1;
+    lRequest.mFunction = MODBUS_FUNCTION_READ_HOLDING_REGISTERS;
+
+    Modbus_Master_Init(&lMaster, MASTER_UART, NULL, 0, sMasterOutputEnable);
+
+    Modbus_Master_Tick(&lMaster, 1);
+
+    Modbus_Master_Submit(&lMaster, &lRequest);
+
+    Stub_Wait(5000);
+
+    Modbus_Master_Work(&lMaster);
+
+    lSize_byte = Stub_Sent(MASTER_UART, lFrame, sizeof(lFrame));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK(1 == Stub_Output(sMasterOutputEnable));
+
+    Stub_Wait((uint32_t)UART_CharTime_us(MASTER_UART) * lSize_byte);
+    TEST_CHECK(0 == Stub_Output(sMasterOutputEnable));
+
+    Modbus_CRC_Compute_Buffer(lResponse, 5);
+
+    Stub_Receive(MASTER_UART, lResponse, sizeof(lResponse), 500);
+
+    for (i = 0; i < 4; i++)
+    {
+        Stub_Wait(250);
+
+        Modbus_Master_Work(&lMaster);
+    }
+
+    TEST_CHECK(MODBUS_NO_ERROR == lRequest.mResult);
+    TEST_CHECK(0x5678 == lData);
+}
+
+// The output enable drops when the last byte of the response left the
+// transmitter
+void OutputEnable_Slave()
+{
+    // Read register 0
+    uint8_t lRequest[8] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+
+    uint8_t      lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t     lSize_byte = 0;
+    uint32_t     lTx_us;
+    unsigned int i;
+
+    Modbus_CRC_Compute_Buffer(lRequest, 6);
+
+    Stub_Receive(TEST_UART, lRequest, sizeof(lRequest), 5000);
+
+    // Modbus_Slave_Work starts the response
+    for (i = 0; (i < 100) && (0 == lSize_byte); i++)
+    {
+        Stub_Wait(250);
+
+        Modbus_Slave_Work();
+
+        lSize_byte = Stub_Sent(TEST_UART, lResponse, sizeof(lResponse));
+    }
+
+    TEST_CHECK(7 == lSize_byte);
+    TEST_CHECK(1 == Stub_Output(sSlaveOutputEnable));
+
+    lTx_us = (uint32_t)UART_CharTime_us(TEST_UART) * lSize_byte;
+
+    Stub_Wait(lTx_us - 1);
+    TEST_CHECK(1 == Stub_Output(sSlaveOutputEnable));
+
+    Stub_Wait(1);
+    TEST_CHECK(0 == Stub_Output(sSlaveOutputEnable));
+
+    Test_Slave_Run(10);
+}
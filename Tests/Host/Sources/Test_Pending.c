@@ -0,0 +1,176 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Pending.c
+
+// Read callbacks returning MODBUS_SLAVE_PENDING
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// The callbacks complete at their fourth call for a range
+#define CALL_QTY (4)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static unsigned int sCalls;
+static unsigned int sRangeCalls[3];
+
+static uint16_t sRegisters[2] = { 0x1111, 0x2222 };
+
+static uint8_t Async_Read    (struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+static uint8_t Async_ReadBits(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData);
+
+// The callbacks provide the values of the ranges 0 and 10, the range 20
+// has a storage the callback overrides.
+static Modbus_Slave_Range sRanges[3] =
+{
+    { NULL,  0, 2, NULL      , Async_Read, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 10, 2, NULL      , Async_Read, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 20, 2, sRegisters, Async_Read, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static Modbus_Slave_Range sCoils[1] =
+{
+    { NULL, 0, 8, NULL, Async_ReadBits, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Read         ();
+static void ReadBits     ();
+static void ReadTwoRanges();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 3);
+
+    Modbus_Slave_InitBits(sCoils, 1, NULL, 0);
+
+    Test_Slave_Run(10);
+
+    Read         ();
+    ReadBits     ();
+    ReadTwoRanges();
+
+    return Test_Result("Test_Pending");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+// Fill aData at the first call only, as an asynchronous operation would
+uint8_t Async_Read(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    unsigned int* lRangeCalls = sRangeCalls + (aRange - sRanges);
+    unsigned int  i;
+
+    sCalls++;
+    (*lRangeCalls)++;
+
+    if (1 == *lRangeCalls)
+    {
+        for (i = 0; i < aCount; i++)
+        {
+            aData[i] = 0xa000 + aAddress + i;
+        }
+    }
+
+    return (CALL_QTY > *lRangeCalls) ? MODBUS_SLAVE_PENDING : MODBUS_NO_ERROR;
+}
+
+uint8_t Async_ReadBits(struct Modbus_Slave_Range_s* aRange, uint16_t aAddress, uint16_t aCount, uint16_t* aData)
+{
+    sCalls++;
+
+    if (1 == sCalls)
+    {
+        aData[0] = 0x00a5;
+    }
+
+    return (CALL_QTY > sCalls) ? MODBUS_SLAVE_PENDING : MODBUS_NO_ERROR;
+}
+
+void Read()
+{
+    static const uint8_t REQUEST_0 [] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0,  0, 0, 2 };
+    static const uint8_t REQUEST_20[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 20, 0, 2 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    sCalls = 0;
+    memset(sRangeCalls, 0, sizeof(sRangeCalls));
+
+    lSize_byte = Test_Slave_Request(REQUEST_0, sizeof(REQUEST_0), lResponse, sizeof(lResponse));
+    TEST_CHECK(CALL_QTY == sCalls);
+    TEST_CHECK(9 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK((0xa0 == lResponse[3]) && (0x00 == lResponse[4]) && (0xa0 == lResponse[5]) && (0x01 == lResponse[6]));
+
+    sCalls = 0;
+    memset(sRangeCalls, 0, sizeof(sRangeCalls));
+
+    lSize_byte = Test_Slave_Request(REQUEST_20, sizeof(REQUEST_20), lResponse, sizeof(lResponse));
+    TEST_CHECK(CALL_QTY == sCalls);
+    TEST_CHECK(9 == lSize_byte);
+    TEST_CHECK((0xa0 == lResponse[3]) && (0x14 == lResponse[4]) && (0xa0 == lResponse[5]) && (0x15 == lResponse[6]));
+}
+
+void ReadBits()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_COILS, 0, 0, 0, 8 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    sCalls = 0;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(CALL_QTY == sCalls);
+    TEST_CHECK(6 == lSize_byte);
+    TEST_CHECK((1 == lResponse[2]) && (0xa5 == lResponse[3]));
+}
+
+// Each sub-request is pending in turn, the records of the completed one
+// stay in the response.
+void ReadTwoRanges()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 14, 6, 0, 1, 0, 0, 0, 2, 6, 0, 1, 0, 10, 0, 2 };
+
+    static const uint8_t RESPONSE[] = { 1, MODBUS_FUNCTION_READ_FILE_RECORD, 12, 5, 6, 0xa0, 0x00, 0xa0, 0x01, 5, 6, 0xa0, 0x0a, 0xa0, 0x0b };
+
+    static const Modbus_Slave_File FILES[1] = { { 1, sRanges, 2 } };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    Modbus_Slave_InitFiles(FILES, 1);
+
+    sCalls = 0;
+    memset(sRangeCalls, 0, sizeof(sRangeCalls));
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(2 * CALL_QTY == sCalls);
+    TEST_CHECK(sizeof(RESPONSE) + sizeof(uint16_t) == lSize_byte);
+    TEST_CHECK(0 == memcmp(RESPONSE, lResponse, sizeof(RESPONSE)));
+}
@@ -0,0 +1,156 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Rate.c
+
+// Responses at 115200 bps, with Modbus_Slave_Tick called every 10 ms
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+#include "UART.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define TICK_PERIOD_ms (10)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static GPIO sOutputEnable;
+
+static uint16_t sRegisters[125];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 125, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aRequest  The request without its CRC
+//
+// Return  The size of the response
+static uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte, uint8_t* aResponse);
+
+static void Run(uint16_t aDuration_ms);
+
+static void LongResponse ();
+static void ShortResponse();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    memset(&sOutputEnable, 0, sizeof(sOutputEnable));
+
+    sOutputEnable.mBit  = 3;
+    sOutputEnable.mPort = GPIO_PORT_C;
+
+    Test_Slave_Init(sRanges, 1);
+
+    UART_Configure(TEST_UART, 115200, UART_PARITY_NONE, 1);
+
+    Run(TICK_PERIOD_ms);
+
+    ShortResponse();
+    LongResponse ();
+
+    return Test_Result("Test_Rate");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte, uint8_t* aResponse)
+{
+    uint8_t lFrame[MODBUS_ADU_MAX_byte];
+
+    memcpy(lFrame, aRequest, aRequestSize_byte);
+
+    Modbus_CRC_Compute_Buffer(lFrame, aRequestSize_byte);
+
+    Stub_Receive(TEST_UART, lFrame, aRequestSize_byte + sizeof(uint16_t), 5000);
+
+    // Wait for the start of the response
+    while (!Stub_Output(sOutputEnable))
+    {
+        Stub_Wait(50);
+
+        Modbus_Slave_Work();
+    }
+
+    // A tick right after the start of the response
+    Modbus_Slave_Tick(TICK_PERIOD_ms);
+    Modbus_Slave_Work();
+    TEST_CHECK(Stub_Output(sOutputEnable));
+
+    Run(3 * TICK_PERIOD_ms);
+    TEST_CHECK(!Stub_Output(sOutputEnable));
+
+    return Stub_Sent(TEST_UART, aResponse, MODBUS_ADU_MAX_byte);
+}
+
+void Run(uint16_t aDuration_ms)
+{
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < aDuration_ms / TICK_PERIOD_ms; i++)
+    {
+        for (j = 0; j < 4 * TICK_PERIOD_ms; j++)
+        {
+            Stub_Wait(250);
+
+            Modbus_Slave_Work();
+        }
+
+        Modbus_Slave_Tick(TICK_PERIOD_ms);
+    }
+}
+
+// 255 bytes, 22 ms
+void LongResponse()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 125 };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    lSize_byte = Request(REQUEST, sizeof(REQUEST), lResponse);
+    TEST_CHECK(255 == lSize_byte);
+    TEST_CHECK((255 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(2 == lCounters.mServerMessages);
+    TEST_CHECK(0 == lCounters.mBusCommErrors);
+}
+
+// 8 bytes, less than 1 ms
+void ShortResponse()
+{
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 1, 0x12, 0x34 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Request(REQUEST, sizeof(REQUEST), lResponse);
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK(0 == memcmp(REQUEST, lResponse, sizeof(REQUEST)));
+    TEST_CHECK(0x1234 == sRegisters[1]);
+}
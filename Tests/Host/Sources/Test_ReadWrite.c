@@ -0,0 +1,101 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_ReadWrite.c
+
+// Read/Write Multiple Registers (FC23)
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters[4];
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Limits();
+static void WriteThenRead();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+    Test_Slave_Run(10);
+
+    Limits       ();
+    WriteThenRead();
+
+    return Test_Result("Test_ReadWrite");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Limits()
+{
+    // Read 0 register
+    static const uint8_t READ_0[] = { 1, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0 };
+
+    // The byte count does not match the write count
+    static const uint8_t BYTE_COUNT[] = { 1, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, 0, 0, 0, 1, 0, 0, 0, 1, 4, 0, 0, 0, 0 };
+
+    // Write past the end of the range
+    static const uint8_t WRITE_OUT[] = { 1, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, 0, 0, 0, 1, 0, 3, 0, 2, 4, 0, 0, 0, 0 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(READ_0, sizeof(READ_0), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(BYTE_COUNT, sizeof(BYTE_COUNT), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE);
+
+    lSize_byte = Test_Slave_Request(WRITE_OUT, sizeof(WRITE_OUT), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+
+    TEST_CHECK((0 == sRegisters[2]) && (0 == sRegisters[3]));
+}
+
+void WriteThenRead()
+{
+    // Write registers 1 and 2, read registers 0 to 2
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS, 0, 0, 0, 3, 0, 1, 0, 2, 4, 0x12, 0x34, 0x56, 0x78 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    sRegisters[0] = 0xabcd;
+
+    // The response contains the values written by the same request
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(11 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(MODBUS_FUNCTION_READ_WRITE_MULTIPLE_REGISTERS == lResponse[MODBUS_BYTE_FUNCTION]);
+    TEST_CHECK(6 == lResponse[2]);
+    TEST_CHECK((0xab == lResponse[3]) && (0xcd == lResponse[4]));
+    TEST_CHECK((0x12 == lResponse[5]) && (0x34 == lResponse[6]));
+    TEST_CHECK((0x56 == lResponse[7]) && (0x78 == lResponse[8]));
+
+    TEST_CHECK((0x1234 == sRegisters[1]) && (0x5678 == sRegisters[2]));
+}
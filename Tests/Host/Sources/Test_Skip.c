@@ -0,0 +1,96 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Skip.c
+
+// Frames for other slaves
+
+// ===== C ==================================================================
+#include <stdint.h>
+#include <string.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Stub.h"
+#include "Test.h"
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters[4] = { 0x1234, 0x5678, 0x9abc, 0xdef0 };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 4, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+static void Foreign_Then_Addressed(uint8_t aFast);
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Foreign_Then_Addressed(0);
+    Foreign_Then_Addressed(1);
+
+    return Test_Result("Test_Skip");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Foreign_Then_Addressed(uint8_t aFast)
+{
+    static const uint8_t FOREIGN[] = { 2, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 0, 0, 2, 4, 1, 2, 3, 4 };
+    static const uint8_t REQUEST[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 2 };
+
+    Modbus_Slave_Counters lCounters;
+    uint8_t               lFrame[MODBUS_ADU_MAX_byte];
+    uint8_t               lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t              lSize_byte;
+
+    Test_Slave_Init(sRanges, 1);
+
+    if (aFast)
+    {
+        Modbus_Slave_InitFastRead();
+    }
+
+    Test_Slave_Run(10);
+
+    // The slave skips the frame for device 2, then responds to the next one
+    // without missing its start.
+    memcpy(lFrame, FOREIGN, sizeof(FOREIGN));
+    Modbus_CRC_Compute_Buffer(lFrame, sizeof(FOREIGN));
+    Stub_Receive(TEST_UART, lFrame, sizeof(FOREIGN) + sizeof(uint16_t), 5000);
+
+    Test_Slave_Run(10);
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(9 == lSize_byte);
+    TEST_CHECK(Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(4 == lResponse[2]);
+    TEST_CHECK((0x56 == lResponse[3]) && (0x78 == lResponse[4]) && (0x9a == lResponse[5]) && (0xbc == lResponse[6]));
+
+    // The second request follows the foreign frame after 3.5 characters,
+    // before Modbus_Slave_Work is called.
+    Stub_Receive(TEST_UART, lFrame, sizeof(FOREIGN) + sizeof(uint16_t), 5000);
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(9 == lSize_byte);
+
+    Modbus_Slave_GetCounters(&lCounters);
+    TEST_CHECK(4 == lCounters.mBusMessages);
+    TEST_CHECK(0 == lCounters.mBusCommErrors);
+    TEST_CHECK(2 == lCounters.mServerMessages);
+    TEST_CHECK(0 == lCounters.mOverruns);
+}
@@ -0,0 +1,159 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Stats.c
+
+// Access statistics of the ranges, Modbus_Slave_GetStats
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+// Read registers 0 to 2
+static const uint8_t READ[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 3 };
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint8_t sFrame[16];
+
+static Modbus_Slave_Cache sCache = { sFrame, sizeof(sFrame) };
+
+static uint16_t sReadOnly [4];
+static uint16_t sRegisters[10];
+
+static Modbus_Slave_Stats sReadOnlyStats;
+static Modbus_Slave_Stats sRegisterStats;
+
+static Modbus_Slave_Range sRanges[2] =
+{
+    { NULL,   0, 10, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, &sCache, NULL, 0, NULL, &sRegisterStats },
+    { NULL, 100,  4, sReadOnly , Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Error  , NULL   , NULL, 0, NULL, &sReadOnlyStats },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// Return  The size of the response
+static uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte);
+
+static void Stats_Access   ();
+static void Stats_Count    ();
+static void Stats_Exception();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 2);
+    Test_Slave_Run(10);
+
+    Stats_Count    ();
+    Stats_Exception();
+    Stats_Access   ();
+
+    return Test_Result("Test_Stats");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+uint16_t Request(const uint8_t* aRequest, uint16_t aRequestSize_byte)
+{
+    uint8_t lResponse[MODBUS_ADU_MAX_byte];
+
+    return Test_Slave_Request(aRequest, aRequestSize_byte, lResponse, sizeof(lResponse));
+}
+
+// mAccess_ms of Modbus_Slave_GetStats is the time since the last
+// operation
+void Stats_Access()
+{
+    Modbus_Slave_Stats lAfter;
+    Modbus_Slave_Stats lBefore;
+
+    TEST_CHECK(11 == Request(READ, sizeof(READ)));
+
+    Modbus_Slave_GetStats(sRanges + 0, &lBefore);
+    TEST_CHECK(160 >= lBefore.mAccess_ms);
+
+    Test_Slave_Run(100);
+
+    Modbus_Slave_GetStats(sRanges + 0, &lAfter);
+    TEST_CHECK(lBefore.mAccess_ms + 100 == lAfter.mAccess_ms);
+
+    // The other range was not accessed since
+    Modbus_Slave_GetStats(sRanges + 1, &lAfter);
+    TEST_CHECK(lBefore.mAccess_ms + 100 < lAfter.mAccess_ms);
+}
+
+// The reads, the cached ones included, and the writes are counted with
+// their registers
+void Stats_Count()
+{
+    // Write registers 4 and 5
+    static const uint8_t WRITE[] = { 1, MODBUS_FUNCTION_WRITE_MULTIPLE_REGISTERS, 0, 4, 0, 2, 4, 0, 1, 0, 2 };
+
+    // Read registers 100 to 103
+    static const uint8_t READ_ONLY[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 100, 0, 4 };
+
+    Modbus_Slave_Stats lStats;
+
+    Modbus_Slave_GetStats(sRanges + 0, &lStats);
+    TEST_CHECK((0 == lStats.mReads) && (0 == lStats.mWrites) && (0 == lStats.mRegisters));
+    TEST_CHECK(10 <= lStats.mAccess_ms);
+
+    TEST_CHECK(11 == Request(READ     , sizeof(READ     )));
+    TEST_CHECK(11 == Request(READ     , sizeof(READ     )));
+    TEST_CHECK( 8 == Request(WRITE    , sizeof(WRITE    )));
+    TEST_CHECK(13 == Request(READ_ONLY, sizeof(READ_ONLY)));
+
+    Modbus_Slave_GetStats(sRanges + 0, &lStats);
+    TEST_CHECK(2 == lStats.mReads);
+    TEST_CHECK(1 == lStats.mWrites);
+    TEST_CHECK(8 == lStats.mRegisters);
+    TEST_CHECK(0 == lStats.mExceptions);
+
+    Modbus_Slave_GetStats(sRanges + 1, &lStats);
+    TEST_CHECK(1 == lStats.mReads);
+    TEST_CHECK(0 == lStats.mWrites);
+    TEST_CHECK(4 == lStats.mRegisters);
+}
+
+// A write mBeforeWrite rejects counts as an exception. A request outside
+// the ranges is not counted.
+void Stats_Exception()
+{
+    // Write register 101
+    static const uint8_t READ_ONLY[] = { 1, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 101, 0x12, 0x34 };
+
+    // Read registers 9 and 10, past the end of the first range
+    static const uint8_t OUTSIDE[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 9, 0, 2 };
+
+    Modbus_Slave_Stats lStats;
+
+    TEST_CHECK(5 == Request(READ_ONLY, sizeof(READ_ONLY)));
+    TEST_CHECK(5 == Request(OUTSIDE  , sizeof(OUTSIDE  )));
+
+    Modbus_Slave_GetStats(sRanges + 1, &lStats);
+    TEST_CHECK(1 == lStats.mExceptions);
+    TEST_CHECK(0 == lStats.mWrites);
+    TEST_CHECK(4 == lStats.mRegisters);
+
+    Modbus_Slave_GetStats(sRanges + 0, &lStats);
+    TEST_CHECK(0 == lStats.mExceptions);
+    TEST_CHECK(2 == lStats.mReads);
+}
@@ -0,0 +1,147 @@
+
+// Author    KMS - Martin Dubois, P. Eng.
+// Copyright (C) 2026 KMS
+// License   http://www.apache.org/licenses/LICENSE-2.0
+// Product   KMS-uC
+// File      Tests/Host/Sources/Test_Units.c
+
+// Several unit IDs on the same port, each with its own address space
+
+// ===== C ==================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Includes ===========================================================
+#include "Modbus.h"
+#include "Modbus_CRC.h"
+#include "Modbus_Slave.h"
+
+#include "Test.h"
+
+// Constants
+// //////////////////////////////////////////////////////////////////////////
+
+#define UNIT_QTY (3)
+
+// Variables
+// //////////////////////////////////////////////////////////////////////////
+
+static uint16_t sRegisters    [1] = { 0x0101 };
+static uint16_t sUnitRegisters[UNIT_QTY][2] = { { 0xf7f7, 0 }, { 0x0505, 0 }, { 0x0202, 0 } };
+
+static Modbus_Slave_Range sRanges[1] =
+{
+    { NULL, 0, 1, sRegisters, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+static Modbus_Slave_Range sUnitRanges[UNIT_QTY] =
+{
+    { NULL, 0, 2, sUnitRegisters[0], Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 0, 2, sUnitRegisters[1], Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+    { NULL, 0, 2, sUnitRegisters[2], Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, NULL, NULL, 0, NULL, NULL },
+};
+
+// The units are not sorted, the unit ID 247 is the highest one
+static const Modbus_Slave_Unit UNITS[UNIT_QTY] =
+{
+    { 247, sUnitRanges + 0, 1 },
+    {   5, sUnitRanges + 1, 1 },
+    {   2, sUnitRanges + 2, 1 },
+};
+
+// Static function declarations
+// //////////////////////////////////////////////////////////////////////////
+
+// aValue  The expected value of register 0
+static void Read(uint8_t aDevice, uint16_t aValue);
+
+static void Units_Read   ();
+static void Units_Unknown();
+static void Units_Write  ();
+
+// Entry point
+// //////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    Test_Slave_Init(sRanges, 1);
+
+    Modbus_Slave_InitUnits(UNITS, UNIT_QTY);
+
+    Test_Slave_Run(10);
+
+    Units_Read   ();
+    Units_Unknown();
+    Units_Write  ();
+
+    return Test_Result("Test_Units");
+}
+
+// Static functions
+// //////////////////////////////////////////////////////////////////////////
+
+void Read(uint8_t aDevice, uint16_t aValue)
+{
+    uint8_t lRequest[] = { aDevice, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(lRequest, sizeof(lRequest), lResponse, sizeof(lResponse));
+    TEST_CHECK(7 == lSize_byte);
+    TEST_CHECK((7 == lSize_byte) && Modbus_CRC_Verify_Buffer(lResponse, lSize_byte));
+    TEST_CHECK(aDevice == lResponse[MODBUS_BYTE_DEVICE]);
+    TEST_CHECK((uint8_t)(aValue >> 8) == lResponse[3]);
+    TEST_CHECK((uint8_t) aValue       == lResponse[4]);
+}
+
+// Each unit ID reads its own register 0, the main unit stays active
+void Units_Read()
+{
+    Read(  1, 0x0101);
+    Read(  2, 0x0202);
+    Read(  5, 0x0505);
+    Read(247, 0xf7f7);
+}
+
+// The requests for the other unit IDs are ignored. Register 1 exists in
+// unit 5 only.
+void Units_Unknown()
+{
+    static const uint8_t READ_1_1[] = { 1, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 1 };
+    static const uint8_t READ_5_1[] = { 5, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 1, 0, 1 };
+    static const uint8_t READ_6_0[] = { 6, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, 0, 0, 0, 1 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(READ_6_0, sizeof(READ_6_0), lResponse, sizeof(lResponse));
+    TEST_CHECK(0 == lSize_byte);
+
+    lSize_byte = Test_Slave_Request(READ_5_1, sizeof(READ_5_1), lResponse, sizeof(lResponse));
+    TEST_CHECK(7 == lSize_byte);
+
+    lSize_byte = Test_Slave_Request(READ_1_1, sizeof(READ_1_1), lResponse, sizeof(lResponse));
+    Test_Slave_CheckException(lResponse, lSize_byte, MODBUS_FUNCTION_READ_HOLDING_REGISTERS, MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    TEST_CHECK(1 == lResponse[MODBUS_BYTE_DEVICE]);
+}
+
+// A write only modifies the register of its unit
+void Units_Write()
+{
+    static const uint8_t REQUEST[] = { 2, MODBUS_FUNCTION_WRITE_SINGLE_REGISTER, 0, 0, 0x12, 0x34 };
+
+    uint8_t  lResponse[MODBUS_ADU_MAX_byte];
+    uint16_t lSize_byte;
+
+    lSize_byte = Test_Slave_Request(REQUEST, sizeof(REQUEST), lResponse, sizeof(lResponse));
+    TEST_CHECK(8 == lSize_byte);
+    TEST_CHECK((8 == lSize_byte) && (2 == lResponse[MODBUS_BYTE_DEVICE]));
+
+    TEST_CHECK(0x1234 == sUnitRegisters[2][0]);
+    TEST_CHECK(0x0101 == sRegisters    [0]);
+    TEST_CHECK(0x0505 == sUnitRegisters[1][0]);
+    TEST_CHECK(0xf7f7 == sUnitRegisters[0][0]);
+
+    Read(2, 0x1234);
+}
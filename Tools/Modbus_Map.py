@@ -0,0 +1,424 @@
+#!/usr/bin/env python3
+
+# Author    KMS - Martin Dubois, P. Eng.
+# Copyright (C) 2026 KMS
+# License   http://www.apache.org/licenses/LICENSE-2.0
+# Product   KMS-uC
+# File      Tools/Modbus_Map.py
+
+# Generate the Modbus_Slave range tables from a register map
+#
+# Usage
+#   python3 Modbus_Map.py {Map} [--name {Name}] [--out {Folder}]
+#
+# The tool creates {Name}.h, {Name}.c and {Name}.txt. {Name} is the map
+# file name without extension by default. {Name}.txt documents the map for
+# the master side.
+#
+# Map format
+#   One register, coil or discrete input per line. "#" starts a comment.
+#   Fields are separated by spaces, the description is the rest of the line.
+#   Use "-" for an empty field.
+#
+#   Address Type Name Access Format Scale Unit Persist Description
+#
+#   Address  Decimal or hexadecimal (0x...)
+#   Type     coil, discrete, holding or input
+#   Name     C identifier, the member of the backing structure
+#   Access   r or rw. discrete and input are always r.
+#   Format   u16, s16, u32 or s32. 32 bits values use two registers, high
+#            word first. Ignored for coil and discrete.
+#   Scale    Value = Register * Scale, documentation only
+#   Unit     Documentation only
+#   Persist  eeprom or -. The ranges of persistent registers get a
+#            Modbus_Slave_Dirty, use Modbus_Slave_NextDirty to find the
+#            values to save.
+#
+# Example
+#   0x0000 holding Setpoint    rw u16 0.1 C   eeprom Oven set point
+#   0x0001 holding Mode        rw u16 -   -   eeprom 0 = Off, 1 = On
+#   0x0010 input   Temperature r  s16 0.1 C   -      Oven temperature
+#   0x0011 input   Uptime      r  u32 1   s   -      Time since reset
+#   0x0000 coil    Fan         rw -   -   -   -      Fan output
+#
+# Ranges
+#   Holding and input registers share the register address space of
+#   Modbus_Slave, FC03 and FC04 both read them. Adjacent registers with the
+#   same access and persistence are merged into one range, the ranges are
+#   sorted by address. The read only ranges use Modbus_Slave_Callback_Error
+#   as mBeforeWrite.
+#
+#   The range tables initialize every member of Modbus_Slave_Range, update
+#   Write_C when the structure changes. The mData of a register range
+#   points to the first member of the range in the backing structure. The
+#   header verifies at compile time these members are contiguous.
+
+import argparse
+import os
+import re
+import sys
+
+# Constants
+# ///////////////////////////////////////////////////////////////////////////
+
+BIT_TYPES = ("coil", "discrete")
+
+FORMATS = {"u16": ("uint16_t", 1), "s16": ("int16_t", 1), "u32": ("uint16_t", 2), "s32": ("uint16_t", 2)}
+
+RANGE_MAX = 255 # Modbus_Slave_Init uses uint8_t quantities
+
+TYPES = ("coil", "discrete", "holding", "input")
+
+# Data types
+# ///////////////////////////////////////////////////////////////////////////
+
+class Entry:
+
+    def __init__(self, aLine, aFields, aDescription):
+        self.mLine = aLine
+
+        lAddress, lType, lName, lAccess, lFormat, lScale, lUnit, lPersist = aFields
+
+        self.mAddress     = int(lAddress, 0)
+        self.mType        = lType.lower()
+        self.mName        = lName
+        self.mAccess      = lAccess.lower()
+        self.mFormat      = lFormat.lower()
+        self.mScale       = lScale
+        self.mUnit        = lUnit
+        self.mPersist     = ("-" != lPersist)
+        self.mDescription = aDescription
+
+        if self.mType not in TYPES:
+            raise ValueError("Invalid type " + lType)
+
+        if not re.match(r"^[A-Za-z_][A-Za-z0-9_]*$", self.mName):
+            raise ValueError("Invalid name " + lName)
+
+        if self.mAccess not in ("r", "rw"):
+            raise ValueError("Invalid access " + lAccess)
+
+        if self.mType in ("discrete", "input"):
+            self.mAccess = "r"
+
+        if self.mPersist and ("eeprom" != lPersist.lower()):
+            raise ValueError("Invalid persistence " + lPersist)
+
+        if self.mType in BIT_TYPES:
+            self.mCount = 1
+        else:
+            if self.mFormat not in FORMATS:
+                raise ValueError("Invalid format " + lFormat)
+            self.mCount = FORMATS[self.mFormat][1]
+
+        if 0x10000 < self.mAddress + self.mCount:
+            raise ValueError("Invalid address " + lAddress)
+
+    def Key(self):
+        return (self.mAccess, self.mPersist)
+
+class Range:
+
+    def __init__(self, aEntry):
+        self.mAddress = aEntry.mAddress
+        self.mCount   = aEntry.mCount
+        self.mEntries = [aEntry]
+
+    def Access(self ): return self.mEntries[0].mAccess
+    def End    (self ): return self.mAddress + self.mCount
+    def Persist(self ): return self.mEntries[0].mPersist
+
+    def Add(self, aEntry):
+        self.mCount += aEntry.mCount
+        self.mEntries.append(aEntry)
+
+# Functions
+# ///////////////////////////////////////////////////////////////////////////
+
+def Merge(aEntries):
+    lResult = []
+
+    for lEntry in sorted(aEntries, key=lambda e: e.mAddress):
+        if 0 < len(lResult):
+            lLast = lResult[-1]
+            if lLast.End() > lEntry.mAddress:
+                raise ValueError("Line %d - Address 0x%04x overlaps %s" % (lEntry.mLine, lEntry.mAddress, lLast.mEntries[-1].mName))
+            if (lLast.End() == lEntry.mAddress) and (lLast.mEntries[0].Key() == lEntry.Key()):
+                lLast.Add(lEntry)
+                continue
+        lResult.append(Range(lEntry))
+
+    if RANGE_MAX < len(lResult):
+        raise ValueError("Too many ranges")
+
+    return lResult
+
+def Read(aFileName):
+    lResult = []
+
+    with open(aFileName, "r") as lFile:
+        for lIndex, lLine in enumerate(lFile, 1):
+            lLine = lLine.split("#", 1)[0].strip()
+            if 0 == len(lLine):
+                continue
+
+            lParts = lLine.split(None, 8)
+            if 8 > len(lParts):
+                raise ValueError("Line %d - Missing fields" % lIndex)
+
+            lDescription = lParts[8] if 9 == len(lParts) else ""
+
+            try:
+                lResult.append(Entry(lIndex, lParts[:8], lDescription))
+            except ValueError as eE:
+                raise ValueError("Line %d - %s" % (lIndex, eE))
+
+    lNames = set()
+    for lEntry in lResult:
+        if lEntry.mName in lNames:
+            raise ValueError("Line %d - Duplicate name %s" % (lEntry.mLine, lEntry.mName))
+        lNames.add(lEntry.mName)
+
+    return lResult
+
+# ===== Code generation =====================================================
+
+def Banner(aFile, aSource):
+    return ("\n"
+            "// Generated by Tools/Modbus_Map.py from %s - Do not edit\n"
+            "// Product   KMS-uC\n"
+            "// File      %s\n"
+            "\n") % (aSource, aFile)
+
+def Write_C(aName, aRegisters, aCoils, aInputs, aSource):
+    lUpper = aName.upper()
+
+    lOut = Banner(aName + ".c", aSource)
+
+    lOut += ("// ===== C ==================================================================\n"
+             "#include <stdint.h>\n"
+             "#include <stdlib.h>\n"
+             "\n"
+             "// ===== Includes ===========================================================\n"
+             "#include \"%s.h\"\n"
+             "\n"
+             "// Variables\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "%s_Data %s;\n") % (aName, aName, aName)
+
+    lTables = (("Ranges", "REGISTER", aRegisters, 0), ("Coils", "COIL", aCoils, 1), ("Inputs", "INPUT", aInputs, 1))
+
+    for lTable, lMacro, lRanges, lBits in lTables:
+        for i, lRange in enumerate(lRanges):
+            if lRange.Persist():
+                lOut += "\nstatic uint16_t           s%s_DirtyBits_%d[%d];\n" % (lTable, i, (lRange.mCount + 15) // 16)
+                lOut += "static Modbus_Slave_Dirty s%s_Dirty_%d = { s%s_DirtyBits_%d, 0, 0 };\n" % (lTable, i, lTable, i)
+
+    for lTable, lMacro, lRanges, lBits in lTables:
+        if 0 == len(lRanges):
+            continue
+
+        lOut += "\nModbus_Slave_Range %s_%s[%s_%s_QTY] =\n{\n" % (aName, lTable, lUpper, lMacro)
+        lOut += "    // mContext, mAddress, mCount, mData, mAfterRead, mAfterWrite, mBeforeWrite, mCache, mBack, mCommits, mDirty, mStats\n"
+
+        for i, lRange in enumerate(lRanges):
+            if lBits:
+                lData = "%s.m%s_%d" % (aName, lTable, i)
+            else:
+                lData = "&%s.m%s" % (aName, lRange.mEntries[0].mName)
+
+            if "r" == lRange.Access():
+                lBeforeWrite = "Modbus_Slave_Callback_Error"
+            else:
+                lBeforeWrite = "Modbus_Slave_Callback_Default"
+
+            lDirty = "&s%s_Dirty_%d" % (lTable, i) if lRange.Persist() else "NULL"
+
+            lOut += ("    { NULL, 0x%04x, %5d, (uint16_t*)%s, Modbus_Slave_Callback_Default, Modbus_Slave_Callback_Default, %s, NULL, NULL, 0, %s, NULL },\n"
+                     % (lRange.mAddress, lRange.mCount, lData, lBeforeWrite, lDirty))
+
+        lOut += "};\n"
+
+    lOut += ("\n"
+             "// Functions\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "void %s_Init(uint8_t aUART, uint8_t aDevice, GPIO aOutputEnable)\n"
+             "{\n"
+             "    Modbus_Slave_Init(aUART, aDevice, %s_Ranges, %s_REGISTER_QTY, aOutputEnable);\n") % (aName, aName, lUpper)
+
+    if (0 < len(aCoils)) or (0 < len(aInputs)):
+        lCoils  = "%s_Coils, %s_COIL_QTY"   % (aName, lUpper) if 0 < len(aCoils ) else "NULL, 0"
+        lInputs = "%s_Inputs, %s_INPUT_QTY" % (aName, lUpper) if 0 < len(aInputs) else "NULL, 0"
+
+        lOut += "    Modbus_Slave_InitBits(%s, %s);\n" % (lCoils, lInputs)
+
+    lOut += "}\n"
+
+    return lOut
+
+def Write_H(aName, aRegisters, aCoils, aInputs, aSource):
+    lUpper = aName.upper()
+
+    lOut = Banner(aName + ".h", aSource)
+
+    lOut += ("#pragma once\n"
+             "\n"
+             "// ===== C ==================================================================\n"
+             "#include <stddef.h>\n"
+             "\n"
+             "// ===== Includes ===========================================================\n"
+             "#include \"Modbus_Slave.h\"\n"
+             "\n"
+             "// Constants\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "#define %s_REGISTER_QTY (%d)\n"
+             "#define %s_COIL_QTY     (%d)\n"
+             "#define %s_INPUT_QTY    (%d)\n") % (lUpper, len(aRegisters), lUpper, len(aCoils), lUpper, len(aInputs))
+
+    # Position of the bits in the m{Table}_{i} arrays
+    for lTable, lRanges in (("Coils", aCoils), ("Inputs", aInputs)):
+        for i, lRange in enumerate(lRanges):
+            lWidth = len(lUpper) + 6 + max(len(e.mName) for e in lRange.mEntries)
+            lOut += "\n// m%s_%d\n" % (lTable, i)
+            for j, lEntry in enumerate(lRange.mEntries):
+                lOut += "#define %-*s (%d)\n"     % (lWidth, "%s_%s_WORD" % (lUpper, lEntry.mName), j // 16)
+                lOut += "#define %-*s (0x%04x)\n" % (lWidth, "%s_%s_MASK" % (lUpper, lEntry.mName), 1 << (j % 16))
+
+    lOut += ("\n"
+             "// Data types\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "/// \\brief Backing storage of the register map\n"
+             "typedef struct\n"
+             "{\n")
+
+    for lRange in aRegisters:
+        lOut += "    // 0x%04x\n" % lRange.mAddress
+        for lEntry in lRange.mEntries:
+            lType, lCount = FORMATS[lEntry.mFormat]
+            lArray = "[2]" if 2 == lCount else ""
+            lOut += "    %-8s m%s%s;\n" % (lType, lEntry.mName, lArray)
+
+    for lTable, lRanges in (("Coils", aCoils), ("Inputs", aInputs)):
+        for i, lRange in enumerate(lRanges):
+            lOut += "    // %s 0x%04x\n" % (lTable, lRange.mAddress)
+            lOut += "    uint16_t m%s_%d[%d];\n" % (lTable, i, (lRange.mCount + 15) // 16)
+
+    lOut += ("}\n"
+             "%s_Data;\n") % aName
+
+    # Modbus_Slave_Range::mData points to the first member of a range and
+    # the range spans the following ones. The compilation fails if the
+    # compiler adds padding between them.
+    lChecks = ""
+    for i, lRange in enumerate(aRegisters):
+        if 1 < len(lRange.mEntries):
+            lFirst = lRange.mEntries[ 0]
+            lLast  = lRange.mEntries[-1]
+            lChecks += ("typedef char %s_Layout_%d[(offsetof(%s_Data, m%s) - offsetof(%s_Data, m%s) == %d * sizeof(uint16_t)) ? 1 : -1];\n"
+                        % (aName, i, aName, lLast.mName, aName, lFirst.mName, lRange.mCount - lLast.mCount))
+
+    if 0 < len(lChecks):
+        lOut += "\n// The registers of a range are consecutive members, without padding\n" + lChecks
+
+    lOut += ("\n"
+             "// Variables\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "extern %s_Data %s;\n"
+             "\n"
+             "extern Modbus_Slave_Range %s_Ranges[%s_REGISTER_QTY];\n") % (aName, aName, aName, lUpper)
+
+    if 0 < len(aCoils ): lOut += "extern Modbus_Slave_Range %s_Coils[%s_COIL_QTY];\n"   % (aName, lUpper)
+    if 0 < len(aInputs): lOut += "extern Modbus_Slave_Range %s_Inputs[%s_INPUT_QTY];\n" % (aName, lUpper)
+
+    lOut += ("\n"
+             "// Functions\n"
+             "// //////////////////////////////////////////////////////////////////////////\n"
+             "\n"
+             "/// \\brief Initialize Modbus_Slave with the register map\n"
+             "/// \\param aUART         The UART index\n"
+             "/// \\param aDevice       The Modbus device address\n"
+             "/// \\param aOutputEnable See Modbus_Slave_Init\n"
+             "extern void %s_Init(uint8_t aUART, uint8_t aDevice, GPIO aOutputEnable);\n") % aName
+
+    return lOut
+
+def Write_Txt(aName, aRegisters, aCoils, aInputs, aSource):
+    lOut = ("\n"
+            "Generated by Tools/Modbus_Map.py from %s - Do not edit\n"
+            "Product   KMS-uC\n"
+            "File      %s.txt\n") % (aSource, aName)
+
+    lSections = (("Registers - FC03, FC04, FC06 (rw), FC16 (rw), FC22 (rw), FC23", aRegisters),
+                 ("Coils - FC01, FC05 (rw), FC15 (rw)", aCoils),
+                 ("Discrete inputs - FC02", aInputs))
+
+    for lTitle, lRanges in lSections:
+        if 0 == len(lRanges):
+            continue
+
+        lOut += "\n%s\n%s\n\n" % (lTitle, "=" * len(lTitle))
+        lOut += "Address        Name                 Access Format Scale    Unit   Persist Description\n"
+
+        for lRange in lRanges:
+            lAddress = lRange.mAddress
+            for lEntry in lRange.mEntries:
+                lFormat = "bit" if lEntry.mType in BIT_TYPES else lEntry.mFormat
+                lOut += "%5d (0x%04x) %-20s %-6s %-6s %-8s %-6s %-7s %s\n" % (lAddress, lAddress, lEntry.mName, lEntry.mAccess, lFormat, lEntry.mScale, lEntry.mUnit,
+                                                                             "yes" if lEntry.mPersist else "-", lEntry.mDescription)
+                lAddress += lEntry.mCount
+
+    lOut += ("\n"
+             "Value = Register * Scale. 32 bits values use two registers, high word\n"
+             "first. Writing a read only register returns exception 0x02.\n")
+
+    return lOut
+
+def Write_File(aFolder, aFileName, aText):
+    with open(os.path.join(aFolder, aFileName), "w", newline="\n") as lFile:
+        lFile.write(aText)
+
+def Main(aArgs):
+    lParser = argparse.ArgumentParser(description="Generate the Modbus_Slave range tables from a register map")
+    lParser.add_argument("Map")
+    lParser.add_argument("--name")
+    lParser.add_argument("--out", default=".")
+
+    lArgs = lParser.parse_args(aArgs)
+
+    lName   = lArgs.name or os.path.splitext(os.path.basename(lArgs.Map))[0]
+    lSource = os.path.basename(lArgs.Map)
+
+    if not re.match(r"^[A-Za-z_][A-Za-z0-9_]*$", lName):
+        print("ERROR  Invalid name " + lName)
+        return 1
+
+    try:
+        lEntries = Read(lArgs.Map)
+
+        lRegisters = Merge([e for e in lEntries if e.mType in ("holding", "input")])
+        lCoils     = Merge([e for e in lEntries if "coil"     == e.mType])
+        lInputs    = Merge([e for e in lEntries if "discrete" == e.mType])
+    except (OSError, ValueError) as eE:
+        print("ERROR  %s - %s" % (lArgs.Map, eE))
+        return 1
+
+    if 0 == len(lRegisters):
+        print("ERROR  %s - Modbus_Slave_Init needs at least one register" % lArgs.Map)
+        return 1
+
+    Write_File(lArgs.out, lName + ".c"  , Write_C  (lName, lRegisters, lCoils, lInputs, lSource))
+    Write_File(lArgs.out, lName + ".h"  , Write_H  (lName, lRegisters, lCoils, lInputs, lSource))
+    Write_File(lArgs.out, lName + ".txt", Write_Txt(lName, lRegisters, lCoils, lInputs, lSource))
+
+    print("%s - %d registers, %d ranges, %d coil ranges, %d discrete input ranges"
+          % (lName, sum(r.mCount for r in lRegisters), len(lRegisters), len(lCoils), len(lInputs)))
+
+    return 0
+
+if "__main__" == __name__:
+    sys.exit(Main(sys.argv[1:]))